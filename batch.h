@@ -0,0 +1,196 @@
+#pragma once
+
+#include "tridiag.h"
+#include "multivector.h"
+#include "workspace.h"
+#include "view.h"
+
+//class / func decl (forward)
+namespace num
+{
+    template<std::floating_point T>
+    class tridiag_batch;
+    template<std::floating_point T>
+    class tridiag_batch_view;
+
+    template <std::floating_point T>
+    multivector<T> thomas_batch(const tridiag_batch<T> &mats, const multivector<T> &vecs);
+    template <std::floating_point T>
+    multivector<T> thomas_batch(const tridiag_batch_view<T> &mats, std::type_identity_t<multivector_view<const T>> vecs);
+    template <std::floating_point T>
+    void thomas_batch(const tridiag_batch_view<T> &mats, std::type_identity_t<multivector_view<const T>> vecs,
+                      std::type_identity_t<multivector_view<T>> x, workspace<T> &ws);
+}
+
+//class def
+namespace num
+{
+    //count independent systems of equal size, diagonals interleaved so that
+    //row i of a, b, c holds the i-th coefficient of every system (one SIMD lane per system)
+    template<std::floating_point T>
+    class tridiag_batch
+    {
+    public:
+        multivector<T> a, b, c;
+
+        tridiag_batch(std::size_t size = 1, std::size_t count = 1, const T &value = 0);
+
+        std::size_t size() const;
+        std::size_t count() const;
+
+        tridiag<T> get(std::size_t k) const;
+        void set(std::size_t k, const tridiag<T> &mat);
+    };
+
+    //read-only view of interleaved diagonals in foreign memory, same layout as tridiag_batch: a from 2
+    template<std::floating_point T>
+    class tridiag_batch_view
+    {
+    public:
+        multivector_view<const T> a, b, c;
+
+        tridiag_batch_view(multivector_view<const T> a,
+                           multivector_view<const T> b,
+                           multivector_view<const T> c);
+        tridiag_batch_view(const tridiag_batch<T> &mats);
+
+        std::size_t size() const;
+        std::size_t count() const;
+    };
+}
+
+//func def
+namespace num
+{
+    template<std::floating_point T>
+    tridiag_batch<T>::tridiag_batch(std::size_t size, std::size_t count, const T &value)
+        : a(size - 1, count, value, 2), b(size, count, value), c(size - 1, count, value) {}
+
+    template<std::floating_point T>
+    std::size_t tridiag_batch<T>::size() const
+    {
+        return b.size();
+    }
+
+    template<std::floating_point T>
+    std::size_t tridiag_batch<T>::count() const
+    {
+        return b.count();
+    }
+
+    template<std::floating_point T>
+    tridiag<T> tridiag_batch<T>::get(std::size_t k) const
+    {
+        tridiag<T> mat(size());
+        mat.a = a.column(k);
+        mat.b = b.column(k);
+        mat.c = c.column(k);
+        return mat;
+    }
+
+    template<std::floating_point T>
+    void tridiag_batch<T>::set(std::size_t k, const tridiag<T> &mat)
+    {
+        a.column(k, mat.a);
+        b.column(k, mat.b);
+        c.column(k, mat.c);
+    }
+
+    template<std::floating_point T>
+    tridiag_batch_view<T>::tridiag_batch_view(multivector_view<const T> a,
+                                              multivector_view<const T> b,
+                                              multivector_view<const T> c)
+        : a(a), b(b), c(c)
+    {
+        this->a.indexing = 2;
+    }
+
+    template<std::floating_point T>
+    tridiag_batch_view<T>::tridiag_batch_view(const tridiag_batch<T> &mats)
+        : tridiag_batch_view(mats.a, mats.b, mats.c) {}
+
+    template<std::floating_point T>
+    std::size_t tridiag_batch_view<T>::size() const
+    {
+        return b.size();
+    }
+
+    template<std::floating_point T>
+    std::size_t tridiag_batch_view<T>::count() const
+    {
+        return b.count();
+    }
+
+    template <std::floating_point T>
+    multivector<T> thomas_batch(const tridiag_batch<T> &mats, const multivector<T> &vecs)
+    {
+        return thomas_batch(tridiag_batch_view<T>(mats), multivector_view<const T>(vecs));
+    }
+
+    template <std::floating_point T>
+    multivector<T> thomas_batch(const tridiag_batch_view<T> &mats, std::type_identity_t<multivector_view<const T>> vecs)
+    {
+        multivector<T> x(mats.size(), mats.count());
+        workspace<T> ws;
+        thomas_batch(mats, vecs, x, ws);
+        return x;
+    }
+
+    //x may alias vecs; L comes from ws, so repeated batches of equal or smaller n * count do not allocate
+    template <std::floating_point T>
+    void thomas_batch(const tridiag_batch_view<T> &mats, std::type_identity_t<multivector_view<const T>> vecs,
+                      std::type_identity_t<multivector_view<T>> x, workspace<T> &ws)
+    {
+        //aliases
+        auto& a = mats.a;
+        auto& b = mats.b;
+        auto& c = mats.c;
+        auto& d = vecs;
+
+        //variables
+        //x holds M during forward iteration, L[i] is the coefficient of x[i + 1] in row i
+        std::size_t n = mats.size(), m = mats.count();
+        multivector_view<T> L(ws.reserve(n * m), n, m, m);
+
+        //forward iteration, inner loops run across systems
+        {
+            const T *b1 = b[1], *d1 = d[1];
+            T *L1 = L[1], *x1 = x[1];
+            for (std::size_t k = 0; k < m; k++)
+            {
+                T r = 1 / b1[k];
+                L1[k] = n > 1 ? c[1][k] * r : 0;
+                x1[k] = d1[k] * r;
+            }
+        }
+        for (std::size_t i = 2; i <= n; i++)
+        {
+            const T *ai = a[i], *bi = b[i], *di = d[i], *Lp = L[i - 1], *xp = x[i - 1];
+            T *Li = L[i], *xi = x[i];
+            if (i < n)
+            {
+                const T *ci = c[i];
+                for (std::size_t k = 0; k < m; k++)
+                {
+                    T r = 1 / (bi[k] - ai[k] * Lp[k]);
+                    Li[k] = ci[k] * r;
+                    xi[k] = (di[k] - ai[k] * xp[k]) * r;
+                }
+            }
+            else
+            {
+                for (std::size_t k = 0; k < m; k++)
+                    xi[k] = (di[k] - ai[k] * xp[k]) / (bi[k] - ai[k] * Lp[k]);
+            }
+        }
+
+        //backward iteration
+        for (std::size_t i = n - 1; i > 0; i--)
+        {
+            const T *Li = L[i], *xn = x[i + 1];
+            T *xi = x[i];
+            for (std::size_t k = 0; k < m; k++)
+                xi[k] -= Li[k] * xn[k];
+        }
+    }
+}
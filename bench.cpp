@@ -0,0 +1,227 @@
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <functional>
+
+#include "tridiag.h"
+#include "solve.h"
+#include "fixed.h"
+
+using real = double;
+
+struct measurement
+{
+    std::string kernel;
+    std::size_t size, reps;
+    real median, p10, p90;  //ns per call
+    real ns_per_row, gb_per_s;
+};
+
+struct options
+{
+    std::size_t reps = 21, warmup = 3, max_size = 10000000;
+    std::string csv, json;
+};
+
+//nanoseconds per call of every repetition, small sizes are timed over several calls per repetition
+std::vector<real> sample(const std::function<void()> &kernel, std::size_t size, const options &opts)
+{
+    std::size_t inner = std::max<std::size_t>(1, 100000 / size);
+    for (std::size_t w = 0; w < opts.warmup; w++)
+        kernel();
+
+    std::vector<real> times;
+    for (std::size_t r = 0; r < opts.reps; r++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < inner; k++)
+            kernel();
+        std::chrono::duration<real, std::nano> time = std::chrono::steady_clock::now() - start;
+        times.push_back(time.count() / inner);
+    }
+    std::ranges::sort(times);
+    return times;
+}
+
+real percentile(const std::vector<real> &sorted, real p)
+{
+    return sorted[std::size_t(p * (sorted.size() - 1) + 0.5)];
+}
+
+measurement measure(const std::string &kernel, std::size_t size, std::size_t bytes,
+                    const std::function<void()> &func, const options &opts)
+{
+    auto times = sample(func, size, opts);
+    real median = percentile(times, 0.5);
+    return { kernel, size, opts.reps, median, percentile(times, 0.1), percentile(times, 0.9),
+             median / size, bytes / median };
+}
+
+options parse_args(int argc, char **argv)
+{
+    options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string key = argv[i], value = argv[i + 1];
+        if (key == "--reps")
+            opts.reps = std::max<std::size_t>(1, std::stoul(value));
+        else if (key == "--warmup")
+            opts.warmup = std::stoul(value);
+        else if (key == "--max-size")
+            opts.max_size = std::stoul(value);
+        else if (key == "--csv")
+            opts.csv = value;
+        else if (key == "--json")
+            opts.json = value;
+    }
+    return opts;
+}
+
+void write_csv(const std::string &path, const std::vector<measurement> &results)
+{
+    std::ofstream out(path);
+    out << "kernel,size,reps,median_ns,p10_ns,p90_ns,ns_per_row,gb_per_s" << std::endl;
+    for (auto &res : results)
+        out << res.kernel << ',' << res.size << ',' << res.reps << ','
+            << res.median << ',' << res.p10 << ',' << res.p90 << ','
+            << res.ns_per_row << ',' << res.gb_per_s << std::endl;
+}
+
+void write_json(const std::string &path, const std::vector<measurement> &results)
+{
+    std::ofstream out(path);
+    out << "[" << std::endl;
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        auto &res = results[i];
+        out << "  {\"kernel\": \"" << res.kernel << "\", \"size\": " << res.size << ", \"reps\": " << res.reps
+            << ", \"median_ns\": " << res.median << ", \"p10_ns\": " << res.p10 << ", \"p90_ns\": " << res.p90
+            << ", \"ns_per_row\": " << res.ns_per_row << ", \"gb_per_s\": " << res.gb_per_s << "}"
+            << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "]" << std::endl;
+}
+
+//tiny systems solved through tridiag_fixed against the same system in heap-backed types
+template<std::size_t N>
+std::vector<measurement> measure_fixed(const options &opts, volatile real &sink)
+{
+    num::tridiag<real> mat(N, -1.0, 1.0, 10.0, 12.0, -1.0, 1.0);
+    num::vector<real> vec(N, -5.0, 5.0), x(N);
+    num::workspace<real> ws(N);
+    num::tridiag_fixed<real, N> mat_fixed(mat);
+    num::vector_fixed<real, N> vec_fixed(vec);
+    std::size_t bytes = 9 * N * sizeof(real);
+
+    return {
+        measure("thomas_alg_workspace", N, bytes,
+                [&]() { num::thomas_alg(mat, vec, x, ws); sink = sink + x[1]; }, opts),
+        measure("thomas_alg_fixed", N, bytes,
+                [&]() { sink = sink + num::thomas_alg(mat_fixed, vec_fixed)[1]; }, opts)
+    };
+}
+
+//the same system stored in each memory resource; x and the workspace are allocated on every call,
+//so the timing includes allocation and first touch of scratch memory
+std::vector<measurement> measure_resources(std::size_t size, const options &opts, volatile real &sink)
+{
+    num::huge_page_resource huge;
+    num::arena_resource arena(2 * size * sizeof(real) + 2 * num::arena_resource::block_alignment);
+    std::vector<std::pair<std::string, std::pmr::memory_resource *>> resources = {
+        { "new_delete", std::pmr::new_delete_resource() },
+        { "aligned_64", num::default_resource() },
+        { "huge_page", &huge },
+        { "arena", &arena }
+    };
+
+    std::vector<measurement> res;
+    for (auto &[name, resource] : resources)
+    {
+        auto storage = resource == &arena ? num::default_resource() : resource;
+        num::tridiag<real> mat(size, -1.0, 1.0, 10.0, 12.0, -1.0, 1.0, num::random_key{ size }, storage);
+        num::vector<real> vec(size, -5.0, 5.0, num::random_key{ size, 3 }, 1, storage);
+
+        res.push_back(measure("thomas_alg+alloc[" + name + "]", size, 9 * size * sizeof(real), [&]()
+        {
+            arena.reset();
+            num::vector<real> x(size, 0, 1, resource);
+            num::workspace<real> ws(0, resource);
+            num::thomas_alg(mat, vec, x, ws);
+            sink = sink + x[1];
+        }, opts));
+        res.push_back(measure("tridiag*vector[" + name + "]", size, 5 * size * sizeof(real),
+                              [&]() { sink = sink + (mat * vec)[1]; }, opts));
+    }
+    return res;
+}
+
+//usage: laba1_bench [--reps N] [--warmup N] [--max-size N] [--csv path] [--json path]
+int main(int argc, char **argv)
+{
+    auto opts = parse_args(argc, argv);
+    std::vector<std::size_t> sizes = { 10, 50, 100, 500, 1000, 5000, 10000, 50000, 100000, 500000, 1000000,
+                                       5000000, 10000000 };
+    std::erase_if(sizes, [&opts](std::size_t size) { return size > opts.max_size; });
+
+    std::vector<measurement> results;
+    volatile real sink = 0;
+    std::cout << "SIMD: " << num::simd::isa() << std::endl;
+    std::cout << std::left << std::setw(32) << "KERNEL" << std::right
+              << std::setw(10) << "SIZE" << std::setw(14) << "MEDIAN, ns" << std::setw(14) << "P90, ns"
+              << std::setw(12) << "ns/row" << std::setw(10) << "GB/s" << std::endl;
+
+    auto print = [&results](const std::vector<measurement> &row_results)
+    {
+        for (auto &res : row_results)
+        {
+            std::cout << std::left << std::setw(32) << res.kernel << std::right << std::defaultfloat << std::setprecision(4)
+                      << std::setw(10) << res.size << std::setw(14) << res.median << std::setw(14) << res.p90
+                      << std::setw(12) << res.ns_per_row << std::setw(10) << res.gb_per_s << std::endl;
+            results.push_back(res);
+        }
+    };
+
+    for (auto size : sizes)
+    {
+        num::tridiag<real> mat(size, -1.0, 1.0, 10.0, 12.0, -1.0, 1.0);
+        num::vector<real> exact(size, -5.0, 5.0), vec = mat * exact, x(size);
+        num::workspace<real> ws(size);
+        std::size_t row = sizeof(real);
+
+        //bytes moved per call are a model: every array element read or written once per pass
+        std::vector<measurement> row_results = {
+            measure("thomas_alg", size, 10 * size * row,
+                    [&]() { sink = sink + num::thomas_alg(mat, vec)[1]; }, opts),
+            measure("thomas_alg_workspace", size, 9 * size * row,
+                    [&]() { num::thomas_alg(mat, vec, x, ws); sink = sink + x[1]; }, opts),
+            measure("pivot_solve", size, 13 * size * row,
+                    [&]() { num::pivot_solve(mat, vec, x, ws); sink = sink + x[1]; }, opts),
+            measure("solve (dominance check + thomas)", size, 12 * size * row,
+                    [&]() { num::solve(mat, vec, x, ws); sink = sink + x[1]; }, opts),
+            measure("unstable_method", size, 13 * size * row,
+                    [&]() { sink = sink + num::unstable_method(mat, vec)[1]; }, opts),
+            measure("tridiag*vector", size, 5 * size * row,
+                    [&]() { sink = sink + (mat * exact)[1]; }, opts),
+            measure("(tridiag*vector-vector).norm", size, 9 * size * row,
+                    [&]() { sink = sink + (mat * x - vec).norm(); }, opts),
+            measure("residual (fused)", size, 5 * size * row,
+                    [&]() { sink = sink + num::residual(mat, x, vec).two; }, opts),
+            measure("vector::norm", size, size * row,
+                    [&]() { sink = sink + exact.norm(); }, opts),
+            measure("vector*vector", size, 2 * size * row,
+                    [&]() { sink = sink + exact * vec; }, opts)
+        };
+        print(row_results);
+        if (size >= 100000)
+            print(measure_resources(size, opts, sink));
+    }
+    print(measure_fixed<8>(opts, sink));
+    print(measure_fixed<32>(opts, sink));
+    print(measure_fixed<64>(opts, sink));
+
+    if (!opts.csv.empty())
+        write_csv(opts.csv, results);
+    if (!opts.json.empty())
+        write_json(opts.json, results);
+    return 0;
+}
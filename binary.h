@@ -0,0 +1,275 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <bit>
+#include <span>
+#include <string>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NUM_HAS_MMAP 1
+#endif
+
+#include "tridiag.h"
+#include "view.h"
+#include "parse.h"
+
+//class / func decl (forward)
+namespace num
+{
+    //file layout: binary_header, then a (n - 1), b (n), c (n - 1), d (n) as contiguous arrays
+    struct binary_header
+    {
+        static constexpr char signature[8] = { 'T', 'R', 'I', 'D', 'I', 'A', 'G', '\0' };
+        static constexpr std::uint32_t current_version = 1;
+
+        char magic[8];
+        std::uint32_t version;
+        std::uint8_t scalar;        //sizeof of scalar type: 4 - float, 8 - double
+        std::uint8_t little_endian; //1 - little endian, 0 - big endian
+        std::uint8_t reserved[2];
+        std::uint64_t size;
+        std::uint64_t reserved_2;
+    };
+    static_assert(sizeof(binary_header) == 32);
+
+    template<std::floating_point T>
+    class mapped_system;
+
+    bool is_binary(const std::string &path);
+
+    template<std::floating_point T>
+    bool write_binary(const std::string &path, const tridiag<T> &mat, const vector<T> &vec);
+
+    template<std::floating_point T>
+    bool text_to_binary(const std::string &text_path, const std::string &binary_path);
+}
+
+//class def
+namespace num
+{
+    //read-only memory mapping of a binary system file, diagonals are exposed as zero-copy spans
+    //with 0-based layout expected by span overloads of solvers
+    template<std::floating_point T>
+    class mapped_system
+    {
+        const char *_data = nullptr;
+        std::size_t _bytes = 0, _size = 0;
+#ifndef NUM_HAS_MMAP
+        std::vector<char> _buffer;
+#endif
+
+        void close();
+
+    public:
+        mapped_system() = default;
+        mapped_system(const mapped_system &other) = delete;
+        mapped_system &operator=(const mapped_system &other) = delete;
+        ~mapped_system();
+
+        bool open(const std::string &path);
+        bool is_open() const;
+
+        std::size_t size() const;
+
+        std::span<const T> a() const;
+        std::span<const T> b() const;
+        std::span<const T> c() const;
+        std::span<const T> d() const;
+
+        tridiag<T> matrix() const;
+        vector<T> rhs() const;
+
+        tridiag_view<T> matrix_view() const;
+        vector_view<const T> rhs_view() const;
+    };
+}
+
+//func def
+namespace num
+{
+    template<std::floating_point T>
+    void mapped_system<T>::close()
+    {
+#ifdef NUM_HAS_MMAP
+        if (_data)
+            munmap(const_cast<char *>(_data), _bytes);
+#else
+        _buffer.clear();
+#endif
+        _data = nullptr;
+        _bytes = _size = 0;
+    }
+
+    template<std::floating_point T>
+    mapped_system<T>::~mapped_system()
+    {
+        close();
+    }
+
+    template<std::floating_point T>
+    bool mapped_system<T>::open(const std::string &path)
+    {
+        close();
+
+#ifdef NUM_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(binary_header))
+        {
+            ::close(fd);
+            return false;
+        }
+        _bytes = st.st_size;
+        void *map = mmap(nullptr, _bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED)
+        {
+            _bytes = 0;
+            return false;
+        }
+        madvise(map, _bytes, MADV_SEQUENTIAL);
+        _data = static_cast<const char *>(map);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.is_open())
+            return false;
+        _bytes = in.tellg();
+        if (_bytes < sizeof(binary_header))
+            return false;
+        _buffer.resize(_bytes);
+        in.seekg(0);
+        in.read(_buffer.data(), _bytes);
+        _data = _buffer.data();
+#endif
+
+        binary_header header;
+        std::memcpy(&header, _data, sizeof(header));
+        bool valid = std::memcmp(header.magic, binary_header::signature, sizeof(header.magic)) == 0
+                     && header.version == binary_header::current_version
+                     && header.scalar == sizeof(T)
+                     && header.little_endian == (std::endian::native == std::endian::little)
+                     && header.size > 0
+                     //bounded before multiplying, a crafted size must not wrap past the length check
+                     && header.size <= ((_bytes - sizeof(header)) / sizeof(T) + 2) / 4
+                     && _bytes >= sizeof(header) + (4 * header.size - 2) * sizeof(T);
+        if (!valid)
+        {
+            close();
+            return false;
+        }
+        _size = header.size;
+        return true;
+    }
+
+    template<std::floating_point T>
+    bool mapped_system<T>::is_open() const
+    {
+        return _data != nullptr;
+    }
+
+    template<std::floating_point T>
+    std::size_t mapped_system<T>::size() const
+    {
+        return _size;
+    }
+
+    template<std::floating_point T>
+    std::span<const T> mapped_system<T>::a() const
+    {
+        return { reinterpret_cast<const T *>(_data + sizeof(binary_header)), _size - 1 };
+    }
+
+    template<std::floating_point T>
+    std::span<const T> mapped_system<T>::b() const
+    {
+        return { a().data() + _size - 1, _size };
+    }
+
+    template<std::floating_point T>
+    std::span<const T> mapped_system<T>::c() const
+    {
+        return { b().data() + _size, _size - 1 };
+    }
+
+    template<std::floating_point T>
+    std::span<const T> mapped_system<T>::d() const
+    {
+        return { c().data() + _size - 1, _size };
+    }
+
+    template<std::floating_point T>
+    tridiag<T> mapped_system<T>::matrix() const
+    {
+        tridiag<T> mat(_size);
+        std::ranges::copy(a(), mat.a.data());
+        std::ranges::copy(b(), mat.b.data());
+        std::ranges::copy(c(), mat.c.data());
+        return mat;
+    }
+
+    template<std::floating_point T>
+    vector<T> mapped_system<T>::rhs() const
+    {
+        vector<T> vec(_size);
+        std::ranges::copy(d(), vec.data());
+        return vec;
+    }
+
+    template<std::floating_point T>
+    tridiag_view<T> mapped_system<T>::matrix_view() const
+    {
+        return tridiag_view<T>(a(), b(), c());
+    }
+
+    template<std::floating_point T>
+    vector_view<const T> mapped_system<T>::rhs_view() const
+    {
+        return d();
+    }
+
+    inline bool is_binary(const std::string &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        char magic[sizeof(binary_header::signature)];
+        return in.read(magic, sizeof(magic)) && std::memcmp(magic, binary_header::signature, sizeof(magic)) == 0;
+    }
+
+    template<std::floating_point T>
+    bool write_binary(const std::string &path, const tridiag<T> &mat, const vector<T> &vec)
+    {
+        std::ofstream out(path, std::ios::binary);
+        if (!out.is_open())
+            return false;
+
+        std::size_t n = mat.size();
+        binary_header header{};
+        std::memcpy(header.magic, binary_header::signature, sizeof(header.magic));
+        header.version = binary_header::current_version;
+        header.scalar = sizeof(T);
+        header.little_endian = std::endian::native == std::endian::little;
+        header.size = n;
+
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(mat.a.data()), (n - 1) * sizeof(T));
+        out.write(reinterpret_cast<const char *>(mat.b.data()), n * sizeof(T));
+        out.write(reinterpret_cast<const char *>(mat.c.data()), (n - 1) * sizeof(T));
+        out.write(reinterpret_cast<const char *>(vec.data()), n * sizeof(T));
+        return out.good();
+    }
+
+    template<std::floating_point T>
+    bool text_to_binary(const std::string &text_path, const std::string &binary_path)
+    {
+        tridiag<T> mat;
+        vector<T> vec;
+        return parse_text(text_path, mat, vec) && write_binary(binary_path, mat, vec);
+    }
+}
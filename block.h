@@ -0,0 +1,322 @@
+#pragma once
+
+#include <array>
+
+#include "vector.h"
+
+//class / func decl (forward)
+namespace num
+{
+    template<std::floating_point T, std::size_t B>
+    class block_tridiag;
+
+    template<std::floating_point T, std::size_t B>
+    bool operator==(const block_tridiag<T, B> &lhs, const block_tridiag<T, B> &rhs);
+    template<std::floating_point T, std::size_t B>
+    bool operator!=(const block_tridiag<T, B> &lhs, const block_tridiag<T, B> &rhs);
+
+    template<std::floating_point T, std::size_t B>
+    vector<T> operator*(const block_tridiag<T, B> &mat, const vector<T> &vec);
+
+    template<std::floating_point T, std::size_t B>
+    std::ostream &operator<<(std::ostream &out, const block_tridiag<T, B> &mat);
+
+    template<std::floating_point T, std::size_t B>
+    vector<T> block_thomas(const block_tridiag<T, B> &mat, const vector<T> &vec);
+}
+
+//class def
+namespace num
+{
+    //tridiagonal matrix of B x B blocks, every block stored contiguously in row-major order;
+    //like tridiag, a(i) exists for i = 2..n, b(i) for i = 1..n, c(i) for i = 1..n - 1.
+    //vectors of size n * B are used with it: block row i holds components (i - 1) * B + 1 .. i * B
+    template<std::floating_point T, std::size_t B>
+    class block_tridiag
+    {
+        static_assert(B > 0);
+
+        std::vector<T> _a, _b, _c;
+
+    public:
+        static constexpr std::size_t block = B;
+
+        block_tridiag(std::size_t size = 1, const T &value = 0);
+        block_tridiag(std::size_t size,
+                      const T &min_a, const T &max_a,
+                      const T &min_b, const T &max_b,
+                      const T &min_c, const T &max_c);
+        block_tridiag(std::size_t size,
+                      const T &min_a, const T &max_a,
+                      const T &min_b, const T &max_b,
+                      const T &min_c, const T &max_c,
+                      const random_key &key);
+
+        std::size_t size() const;
+
+        T *a(std::size_t i);
+        T *b(std::size_t i);
+        T *c(std::size_t i);
+        const T *a(std::size_t i) const;
+        const T *b(std::size_t i) const;
+        const T *c(std::size_t i) const;
+
+        friend bool operator==<T, B>(const block_tridiag &lhs, const block_tridiag &rhs);
+        friend bool operator!=<T, B>(const block_tridiag &lhs, const block_tridiag &rhs);
+    };
+}
+
+//func def
+namespace num
+{
+    //dense B x B kernels, all loop bounds are compile time constants so they are unrolled
+    namespace block_detail
+    {
+        //res = lhs * rhs, rhs has cols columns
+        template<typename T, std::size_t B, std::size_t cols>
+        inline void mul(const T *lhs, const T *rhs, T *res)
+        {
+            for (std::size_t i = 0; i < B; i++)
+            {
+                std::array<T, cols> row{};
+                for (std::size_t k = 0; k < B; k++)
+                    for (std::size_t j = 0; j < cols; j++)
+                        row[j] += lhs[i * B + k] * rhs[k * cols + j];
+                for (std::size_t j = 0; j < cols; j++)
+                    res[i * cols + j] = row[j];
+            }
+        }
+
+        //res -= lhs * rhs, rhs has cols columns
+        template<typename T, std::size_t B, std::size_t cols>
+        inline void mul_sub(const T *lhs, const T *rhs, T *res)
+        {
+            std::array<T, B * cols> prod;
+            mul<T, B, cols>(lhs, rhs, prod.data());
+            for (std::size_t k = 0; k < B * cols; k++)
+                res[k] -= prod[k];
+        }
+
+        //in-place LU without pivoting (blocks are expected to be diagonally dominant as scalars are in thomas_alg),
+        //diagonal of U is stored inverted
+        template<typename T, std::size_t B>
+        inline void lu(T *m)
+        {
+            for (std::size_t k = 0; k < B; k++)
+            {
+                m[k * B + k] = 1 / m[k * B + k];
+                for (std::size_t i = k + 1; i < B; i++)
+                {
+                    m[i * B + k] *= m[k * B + k];
+                    for (std::size_t j = k + 1; j < B; j++)
+                        m[i * B + j] -= m[i * B + k] * m[k * B + j];
+                }
+            }
+        }
+
+        //rhs = (LU)^-1 * rhs in place, rhs has cols columns
+        template<typename T, std::size_t B, std::size_t cols>
+        inline void lu_solve(const T *m, T *rhs)
+        {
+            for (std::size_t i = 1; i < B; i++)
+                for (std::size_t k = 0; k < i; k++)
+                    for (std::size_t j = 0; j < cols; j++)
+                        rhs[i * cols + j] -= m[i * B + k] * rhs[k * cols + j];
+            for (std::size_t i = B; i-- > 0;)
+            {
+                for (std::size_t k = i + 1; k < B; k++)
+                    for (std::size_t j = 0; j < cols; j++)
+                        rhs[i * cols + j] -= m[i * B + k] * rhs[k * cols + j];
+                for (std::size_t j = 0; j < cols; j++)
+                    rhs[i * cols + j] *= m[i * B + i];
+            }
+        }
+    }
+
+    template<std::floating_point T, std::size_t B>
+    block_tridiag<T, B>::block_tridiag(std::size_t size, const T &value)
+        : _a((size > 0 ? size - 1 : 0) * B * B, value), _b(size * B * B, value), _c((size > 0 ? size - 1 : 0) * B * B, value) {}
+
+    template<std::floating_point T, std::size_t B>
+    block_tridiag<T, B>::block_tridiag(std::size_t size,
+                                       const T &min_a, const T &max_a,
+                                       const T &min_b, const T &max_b,
+                                       const T &min_c, const T &max_c)
+        : block_tridiag(size, min_a, max_a, min_b, max_b, min_c, max_c, random_key{ std::random_device()() }) {}
+
+    //entries are drawn as for the scalar matrix: below the diagonal from [min_a, max_a], on it from [min_b, max_b],
+    //above it from [min_c, max_c]; a, b, c blocks use streams key.stream, key.stream + 1, key.stream + 2
+    template<std::floating_point T, std::size_t B>
+    block_tridiag<T, B>::block_tridiag(std::size_t size,
+                                       const T &min_a, const T &max_a,
+                                       const T &min_b, const T &max_b,
+                                       const T &min_c, const T &max_c,
+                                       const random_key &key)
+        : block_tridiag(size)
+    {
+        fill_uniform(_a.data(), _a.size(), min_a, max_a, key);
+        fill_uniform(_c.data(), _c.size(), min_c, max_c, random_key{ key.seed, key.stream + 2 });
+        random_key key_b{ key.seed, key.stream + 1 };
+        for (std::size_t k = 0; k < _b.size(); k++)
+        {
+            std::size_t i = k / B % B, j = k % B;
+            _b[k] = i > j ? uniform(key_b, k, min_a, max_a)
+                  : i < j ? uniform(key_b, k, min_c, max_c)
+                  : uniform(key_b, k, min_b, max_b);
+        }
+    }
+
+    template<std::floating_point T, std::size_t B>
+    std::size_t block_tridiag<T, B>::size() const
+    {
+        return _b.size() / (B * B);
+    }
+
+    template<std::floating_point T, std::size_t B>
+    T *block_tridiag<T, B>::a(std::size_t i)
+    {
+        return _a.data() + (i - 2) * B * B;
+    }
+
+    template<std::floating_point T, std::size_t B>
+    T *block_tridiag<T, B>::b(std::size_t i)
+    {
+        return _b.data() + (i - 1) * B * B;
+    }
+
+    template<std::floating_point T, std::size_t B>
+    T *block_tridiag<T, B>::c(std::size_t i)
+    {
+        return _c.data() + (i - 1) * B * B;
+    }
+
+    template<std::floating_point T, std::size_t B>
+    const T *block_tridiag<T, B>::a(std::size_t i) const
+    {
+        return _a.data() + (i - 2) * B * B;
+    }
+
+    template<std::floating_point T, std::size_t B>
+    const T *block_tridiag<T, B>::b(std::size_t i) const
+    {
+        return _b.data() + (i - 1) * B * B;
+    }
+
+    template<std::floating_point T, std::size_t B>
+    const T *block_tridiag<T, B>::c(std::size_t i) const
+    {
+        return _c.data() + (i - 1) * B * B;
+    }
+
+    template<std::floating_point T, std::size_t B>
+    bool operator==(const block_tridiag<T, B> &lhs, const block_tridiag<T, B> &rhs)
+    {
+        return lhs._a == rhs._a && lhs._b == rhs._b && lhs._c == rhs._c;
+    }
+
+    template<std::floating_point T, std::size_t B>
+    bool operator!=(const block_tridiag<T, B> &lhs, const block_tridiag<T, B> &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<std::floating_point T, std::size_t B>
+    vector<T> operator*(const block_tridiag<T, B> &mat, const vector<T> &vec)
+    {
+        std::size_t n = mat.size();
+        vector<T> res(n * B);
+        const T *x = vec.data();
+        T *r = res.data();
+        std::array<T, B> prod;
+        for (std::size_t i = 1; i <= n; i++)
+        {
+            T *row = r + (i - 1) * B;
+            block_detail::mul<T, B, 1>(mat.b(i), x + (i - 1) * B, row);
+            if (i > 1)
+            {
+                block_detail::mul<T, B, 1>(mat.a(i), x + (i - 2) * B, prod.data());
+                for (std::size_t k = 0; k < B; k++)
+                    row[k] += prod[k];
+            }
+            if (i < n)
+            {
+                block_detail::mul<T, B, 1>(mat.c(i), x + i * B, prod.data());
+                for (std::size_t k = 0; k < B; k++)
+                    row[k] += prod[k];
+            }
+        }
+        return res;
+    }
+
+    //outside dense mode the diagonals are printed block after block, each block row-major
+    template<std::floating_point T, std::size_t B>
+    std::ostream &operator<<(std::ostream &out, const block_tridiag<T, B> &mat)
+    {
+        std::size_t n = mat.size();
+        auto mode = print_mode_of(out, n * B, true);
+        if (mode != print_mode::dense)
+        {
+            //empty matrix: empty diagonals rather than n - 1 wrapping around
+            std::size_t off = n > 0 ? n - 1 : 0;
+            print_diagonal(out, "a", mat.a(2), off * B * B, mode);
+            print_diagonal(out, "b", mat.b(1), n * B * B, mode);
+            print_diagonal(out, "c", mat.c(1), off * B * B, mode);
+            return out;
+        }
+
+        int places = format<T>(out);
+        for (std::size_t i = 1; i <= n; i++)
+        {
+            for (std::size_t r = 0; r < B; r++)
+            {
+                for (std::size_t j = 1; j <= n; j++)
+                {
+                    const T *blk = j == i ? mat.b(i) : j + 1 == i ? mat.a(i) : j == i + 1 ? mat.c(i) : nullptr;
+                    for (std::size_t s = 0; s < B; s++)
+                        out << std::setw(places) << (blk ? blk[r * B + s] : 0);
+                }
+                out << std::endl;
+            }
+        }
+        return out;
+    }
+
+    //block Thomas algorithm: forward iteration factorizes M[i] = b[i] - a[i] * L[i - 1] and keeps
+    //L[i] = M[i]^-1 * c[i], y[i] = M[i]^-1 * (d[i] - a[i] * y[i - 1]); backward x[i] = y[i] - L[i] * x[i + 1]
+    template<std::floating_point T, std::size_t B>
+    vector<T> block_thomas(const block_tridiag<T, B> &mat, const vector<T> &vec)
+    {
+        constexpr std::size_t BB = B * B;
+        std::size_t n = mat.size();
+        vector<T> x = vec;
+        T *y = x.data();
+        std::vector<T> L((n - 1) * BB);
+        std::array<T, BB> m;
+
+        //forward iteration
+        for (std::size_t i = 1; i <= n; i++)
+        {
+            T *yi = y + (i - 1) * B;
+            std::copy_n(mat.b(i), BB, m.data());
+            if (i > 1)
+            {
+                block_detail::mul_sub<T, B, B>(mat.a(i), L.data() + (i - 2) * BB, m.data());
+                block_detail::mul_sub<T, B, 1>(mat.a(i), yi - B, yi);
+            }
+            block_detail::lu<T, B>(m.data());
+            block_detail::lu_solve<T, B, 1>(m.data(), yi);
+            if (i < n)
+            {
+                T *Li = L.data() + (i - 1) * BB;
+                std::copy_n(mat.c(i), BB, Li);
+                block_detail::lu_solve<T, B, B>(m.data(), Li);
+            }
+        }
+
+        //backward iteration
+        for (std::size_t i = n - 1; i > 0; i--)
+            block_detail::mul_sub<T, B, 1>(L.data() + (i - 1) * BB, y + i * B, y + (i - 1) * B);
+
+        return x;
+    }
+}
@@ -0,0 +1,188 @@
+#include <string>
+#include <array>
+#include <iostream>
+#include <memory_resource>
+#include <sstream>
+#include <cmath>
+
+#include "tridiag.h"
+#include "cyclic.h"
+#include "block.h"
+#include "pcr.h"
+#include "partition.h"
+#include "fixed.h"
+#include "memory.h"
+
+//compile-time checks fail the build of this target instead
+
+static_assert([]()
+{
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+    double first = num::nan_max(num::nan_max(0.0, nan), 1.0), last = num::nan_max(num::nan_max(0.0, 1.0), nan);
+    return first != first && last != last && num::nan_max(1.0, 2.0) == 2;
+}(), "nan_max: a NaN in any trial must reach the aggregate");
+
+//fixed-size Thomas algorithm in constant evaluation: a small system gives its solution back
+static_assert([]()
+{
+    constexpr num::tridiag_fixed<double, 4> mat(std::array<double, 3>{ 1, -1, 2 }, std::array<double, 4>{ 4, 5, -6, 7 },
+                                                std::array<double, 3>{ -2, 1, 1 });
+    constexpr num::vector_fixed<double, 4> exact(std::array<double, 4>{ 1, -2, 3, 0.5 });
+    constexpr num::vector_fixed<double, 4> x = num::thomas_alg(mat, mat * exact);
+    double error = 0;
+    for (std::size_t i = 1; i <= 4; i++)
+        error = std::max(error, x[i] > exact[i] ? x[i] - exact[i] : exact[i] - x[i]);
+    return error < 1e-14;
+}(), "thomas_alg on tridiag_fixed must solve at compile time");
+
+//regression checks run by ctest, every failed one is printed and makes the exit code 1
+std::size_t failures = 0;
+
+void check(bool condition, const std::string &what)
+{
+    if (condition)
+        return;
+    std::cerr << "FAILED: " << what << std::endl;
+    failures++;
+}
+
+//move assignment keeps the target's resource: the buffer is taken over only within one resource
+void check_move_assignment()
+{
+    num::arena_resource first(1 << 16), second(1 << 16);
+
+    num::vector<double> x(100, 1, 1, &first), y(100, 2, 1, &first);
+    const double *buffer = x.data();
+    y = std::move(x);
+    check(y.data() == buffer && y.resource() == &first, "move assignment within one resource takes the buffer over");
+
+    num::vector<double> z(100, 3, 1, &second);
+    z = std::move(y);
+    check(z.resource() == &second && z.data() != buffer && z == num::vector<double>(100, 1),
+          "move assignment across resources copies into the target's resource");
+
+    num::tridiag<double> mat(50, 4, &first), other(50, 1, &second);
+    other = std::move(mat);
+    check(other.b.resource() == &second && other == num::tridiag<double>(50, 4),
+          "tridiag move assignment across resources copies into the target's resource");
+
+    //target resource exhausted: the copy throws instead of terminating
+    std::array<std::byte, 1024> storage;
+    std::pmr::monotonic_buffer_resource full(storage.data(), storage.size(), std::pmr::null_memory_resource());
+    num::vector<double> small(100, 0, 1, &full), large(1000, 5, 1, &second);
+    bool thrown = false;
+    try
+    {
+        small = std::move(large);
+    }
+    catch (const std::bad_alloc &)
+    {
+        thrown = true;
+    }
+    check(thrown, "move assignment into an exhausted resource throws std::bad_alloc");
+}
+
+//empty matrices print empty diagonals in every mode instead of n - 1 wrapping around
+void check_empty_print()
+{
+    for (auto mode : { num::print_mode::dense, num::print_mode::diagonals, num::print_mode::plain })
+    {
+        std::ostringstream tri, cyc, blk;
+        tri << num::print_as{ mode } << num::tridiag<double>(0);
+        cyc << num::print_as{ mode } << num::cyclic_tridiag<double>(0);
+        blk << num::print_as{ mode } << num::block_tridiag<double, 2>(0);
+        std::string empty = mode == num::print_mode::dense ? "" : "a: \nb: \nc: \n";
+        check(tri.str() == empty && cyc.str() == empty && blk.str() == empty, "printing an empty matrix");
+    }
+}
+
+//fused residual: nothing is read for n = 0, and the 2-norm neither overflows nor underflows for extreme residuals
+void check_residual()
+{
+    double max = -1, two = -1;
+    num::simd::residual<double>(nullptr, nullptr, nullptr, nullptr, nullptr, 0, max, two);
+    check(max == 0 && two == 0, "residual of an empty system is 0");
+
+    //A = I, x = 0, so r = -d with |r[i]| = scale; the 2-norm is scale * 10
+    for (double scale : { 1e-200, 1.0, 1e200 })
+    {
+        num::tridiag<double> mat(100, 0);
+        for (std::size_t i = 1; i <= 100; i++)
+            mat.b[i] = 1;
+        num::vector<double> x(100, 0), vec(100, scale);
+        auto res = num::residual(mat, x, vec);
+        std::ostringstream what;
+        what << "residual 2-norm for entries of " << scale;
+        check(res.inf == scale && std::abs(res.two / (10 * scale) - 1) < 1e-14, what.str());
+    }
+}
+
+//parallel solvers on systems too small to split: no thread count clamping with an empty range
+void check_small_systems()
+{
+    num::tridiag<double> empty(0);
+    num::vector<double> none(0);
+    for (std::size_t threads : { 0, 1, 4 })
+        check(num::pcr_solve(empty, none, threads).size() == 0, "pcr_solve of an empty system");
+
+    for (std::size_t n = 1; n <= 7; n++)
+    {
+        num::tridiag<double> mat(n, 1);
+        for (std::size_t i = 1; i <= n; i++)
+            mat.b[i] = 4;
+        num::vector<double> vec(n, 1), x = num::thomas_alg(mat, vec);
+        for (std::size_t threads : { 0, 1, 4 })
+            check((num::partition_solve(mat, vec, threads) - x).norm() < 1e-14, "partition_solve of " + std::to_string(n) + " rows");
+    }
+}
+
+//upstream that hands out consecutive pieces of one buffer and records what it gets back
+class recording_resource : public std::pmr::memory_resource
+{
+    alignas(64) std::array<std::byte, 1024> _storage;
+    std::size_t _used = 0;
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        std::size_t first = (_used + alignment - 1) / alignment * alignment;
+        if (first + bytes > _storage.size())
+            throw std::bad_alloc();
+        _used = first + bytes;
+        return _storage.data() + first;
+    }
+    void do_deallocate(void *ptr, std::size_t, std::size_t) override { freed.push_back(ptr); }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+public:
+    std::vector<void *> freed;
+};
+
+//an upstream block right behind the arena's own one is still returned upstream
+void check_arena_deallocation()
+{
+    recording_resource upstream;
+    {
+        num::arena_resource arena(64, &upstream);
+        void *inside = arena.allocate(32), *outside = arena.allocate(128);
+        arena.deallocate(inside, 32);
+        check(upstream.freed.empty(), "arena memory is not returned upstream on deallocation");
+        arena.deallocate(outside, 128);
+        check(upstream.freed.size() == 1 && upstream.freed[0] == outside,
+              "an upstream block starting at the arena's end is returned upstream");
+    }
+    check(upstream.freed.size() == 2, "the arena's block is returned upstream on destruction");
+}
+
+int main()
+{
+    check_move_assignment();
+    check_arena_deallocation();
+    check_empty_print();
+    check_residual();
+    check_small_systems();
+
+    if (failures > 0)
+        return 1;
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,258 @@
+#include <string>
+#include <chrono>
+#include <iostream>
+
+#include "tridiag.h"
+#include "parse.h"
+#include "server.h"
+
+//client of laba1 --serve: sends systems from files or random ones, prints solutions or their residuals
+struct options
+{
+    std::string path, precision = "double";
+    std::vector<std::string> inputs;
+    std::size_t count = 0, size = 0, connections = 1;
+    bool stats = false, shutdown = false;
+};
+
+template<std::floating_point T>
+struct request
+{
+    num::tridiag<T> mat;
+    num::vector<T> vec, x;
+    bool regular = true;        //false when the server answered by error
+};
+
+void usage()
+{
+    std::cerr << "usage: laba1_client SOCKET [options] [input...]" << std::endl
+              << "  -p, --precision NAME       double or float (default double)" << std::endl
+              << "  -r, --random COUNT SIZE    send COUNT random diagonally dominant systems of SIZE" << std::endl
+              << "  -c, --connections N        spread requests over N connections (default 1)" << std::endl
+              << "  --stats                    print server statistics" << std::endl
+              << "  --shutdown                 stop the server afterwards" << std::endl;
+}
+
+bool parse(int argc, char **argv, options &opt)
+{
+    auto count = [](const char *text, std::size_t &value)
+    {
+        std::string_view view(text);
+        auto [ptr, ec] = std::from_chars(view.data(), view.data() + view.size(), value);
+        return ec == std::errc() && ptr == view.data() + view.size() && value > 0;
+    };
+
+    if (argc < 2 || argv[1][0] == '-')
+        return false;
+    opt.path = argv[1];
+    for (int k = 2; k < argc; k++)
+    {
+        std::string arg = argv[k];
+        if (arg == "--stats")
+            opt.stats = true;
+        else if (arg == "--shutdown")
+            opt.shutdown = true;
+        else if ((arg == "-p" || arg == "--precision") && k + 1 < argc)
+            opt.precision = argv[++k];
+        else if ((arg == "-c" || arg == "--connections") && k + 1 < argc)
+        {
+            if (!count(argv[++k], opt.connections))
+                return false;
+        }
+        else if ((arg == "-r" || arg == "--random") && k + 2 < argc)
+        {
+            if (!count(argv[k + 1], opt.count) || !count(argv[k + 2], opt.size))
+                return false;
+            k += 2;
+        }
+        else if (arg[0] != '-' || arg == "-")
+            opt.inputs.push_back(arg);
+        else
+            return false;
+    }
+    return opt.precision == "double" || opt.precision == "float";
+}
+
+//requests are sent from a second thread while replies, which come in any order, are read here
+template<std::floating_point T>
+bool exchange(const std::string &path, std::span<request<T>> part)
+{
+    int fd = num::net::connect_unix(path);
+    if (fd < 0)
+    {
+        std::cerr << "Can not connect to " << path << "." << std::endl;
+        return false;
+    }
+
+    bool valid = true;
+    {
+        std::jthread sender([&]()
+        {
+            std::vector<T> payload;
+            for (std::size_t k = 0; k < part.size(); k++)
+            {
+                auto &mat = part[k].mat;
+                payload.clear();
+                for (const num::vector<T> *values : { &mat.a, &mat.b, &mat.c, &part[k].vec })
+                    payload.insert(payload.end(), values->data(), values->data() + values->size());
+                num::net::frame_header head{ .kind = num::net::frame_kind::solve, .element = sizeof(T),
+                                             .id = k, .size = mat.size() };
+                if (!num::net::send_frame(fd, head, payload.data(), payload.size() * sizeof(T)))
+                    return;
+            }
+        });
+
+        for (std::size_t k = 0; k < part.size(); k++)
+        {
+            num::net::frame_header head;
+            if (!num::net::recv_all(fd, &head, sizeof(head)) || head.magic != num::net::frame_magic)
+            {
+                std::cerr << "Connection closed by server." << std::endl;
+                valid = false;
+                break;
+            }
+            if (head.id >= part.size() || head.size != part[head.id].mat.size() || head.element != sizeof(T))
+            {
+                std::cerr << "Unexpected reply from server." << std::endl;
+                valid = false;
+                break;
+            }
+            auto &x = part[head.id].x;
+            if (head.kind == num::net::frame_kind::error)
+            {
+                std::cerr << "System " << head.id + 1 << " was rejected or is singular." << std::endl;
+                x = num::vector<T>(head.size, std::numeric_limits<T>::quiet_NaN());
+                part[head.id].regular = false;
+                continue;
+            }
+            x = num::vector<T>(head.size);
+            if (!num::net::recv_all(fd, x.data(), num::net::payload_size(head)))
+            {
+                valid = false;
+                break;
+            }
+        }
+        if (!valid)
+            ::shutdown(fd, SHUT_RDWR);
+    }
+    ::close(fd);
+    return valid;
+}
+
+bool control(const std::string &path, num::net::frame_kind kind)
+{
+    int fd = num::net::connect_unix(path);
+    if (fd < 0)
+    {
+        std::cerr << "Can not connect to " << path << "." << std::endl;
+        return false;
+    }
+
+    bool valid = num::net::send_frame(fd, { .kind = kind });
+    if (valid && kind == num::net::frame_kind::stats)
+    {
+        num::net::frame_header head;
+        num::net::server_stats stats;
+        valid = num::net::recv_all(fd, &head, sizeof(head)) && head.kind == num::net::frame_kind::stats &&
+                head.size == sizeof(stats) && num::net::recv_all(fd, &stats, sizeof(stats));
+        if (valid)
+            std::cout << stats;
+    }
+    ::close(fd);
+    return valid;
+}
+
+template<std::floating_point T>
+int run(const options &opt)
+{
+    std::vector<request<T>> requests;
+    bool regular = true;
+    if (opt.count > 0)
+        for (std::size_t k = 0; k < opt.count; k++)
+        {
+            num::random_key key{ k };
+            request<T> req;
+            req.mat = num::tridiag<T>(opt.size, -1, 1, 4, 5, -1, 1, key);
+            req.vec = req.mat * num::vector<T>(opt.size, -1, 1, num::random_key{ k, 3 });
+            requests.push_back(std::move(req));
+        }
+    for (auto &input : opt.inputs)
+    {
+        std::string buffer;
+        if (input == "-")
+            buffer.assign(std::istreambuf_iterator<char>(std::cin), {});
+        else if (!num::read_file(input, buffer))
+        {
+            std::cerr << input << ": can not be read." << std::endl;
+            return 1;
+        }
+        const char *first = buffer.data(), *last = first + buffer.size();
+        while (true)
+        {
+            while (first != last && num::is_space(*first))
+                first++;
+            if (first == last)
+                break;
+            request<T> req;
+            if (!num::parse_next(first, last, req.mat, req.vec))
+            {
+                std::cerr << input << ": system " << requests.size() + 1 << " is not valid." << std::endl;
+                return 1;
+            }
+            requests.push_back(std::move(req));
+        }
+    }
+
+    if (!requests.empty())
+    {
+        //contiguous share of requests per connection
+        std::size_t parts = std::min(opt.connections, requests.size());
+        std::vector<char> done(parts, 0);
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::jthread> clients;
+            for (std::size_t p = 0; p < parts; p++)
+                clients.emplace_back([&, p]()
+                {
+                    std::size_t first = requests.size() * p / parts, last = requests.size() * (p + 1) / parts;
+                    done[p] = exchange<T>(opt.path, { requests.data() + first, last - first });
+                });
+        }
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+        if (std::ranges::any_of(done, [](char d) { return d == 0; }))
+            return 1;
+
+        if (opt.count > 0)
+        {
+            T residual = 0;
+            for (auto &req : requests)
+                residual = std::max(residual, (req.mat * req.x - req.vec).norm());
+            std::cout << std::defaultfloat << "Solved " << requests.size() << " systems in " << seconds.count() << " s ("
+                      << requests.size() / seconds.count() << " per second), max residual " << residual << "." << std::endl;
+        }
+        else
+        {
+            num::text_writer text(std::cout);
+            for (auto &req : requests)
+                num::write_text(text, req.mat, req.x);
+        }
+        regular = std::ranges::all_of(requests, &request<T>::regular);
+    }
+
+    if (opt.stats && !control(opt.path, num::net::frame_kind::stats))
+        return 1;
+    if (opt.shutdown && !control(opt.path, num::net::frame_kind::shutdown))
+        return 1;
+    return regular ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    options opt;
+    if (!parse(argc, argv, opt))
+    {
+        usage();
+        return 2;
+    }
+    return opt.precision == "float" ? run<float>(opt) : run<double>(opt);
+}
@@ -0,0 +1,281 @@
+#pragma once
+
+#include "tridiag.h"
+#include "factorization.h"
+#include "parse.h"
+
+//class / func decl (forward)
+namespace num
+{
+    template<std::floating_point T>
+    class cyclic_tridiag;
+    template<std::floating_point T>
+    class cyclic_tridiag_view;
+
+    template<std::floating_point T>
+    bool operator==(const cyclic_tridiag<T> &lhs, const cyclic_tridiag<T> &rhs);
+    template<std::floating_point T>
+    bool operator!=(const cyclic_tridiag<T> &lhs, const cyclic_tridiag<T> &rhs);
+
+    template<std::floating_point T>
+    vector<T> operator*(const cyclic_tridiag<T> &mat, const vector<T> &vec);
+
+    template<std::floating_point T>
+    std::ostream &operator<<(std::ostream &out, const cyclic_tridiag<T> &mat);
+    template<std::floating_point T>
+    std::istream &operator>>(std::istream &in, cyclic_tridiag<T> &mat);
+
+    template<std::floating_point T>
+    vector<T> cyclic_solve(const cyclic_tridiag<T> &mat, const vector<T> &vec);
+    template<std::floating_point T>
+    vector<T> cyclic_solve(const cyclic_tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec);
+
+    template<std::floating_point T>
+    bool parse_text(const std::string &path, cyclic_tridiag<T> &mat, vector<T> &vec,
+                    std::size_t threads = std::thread::hardware_concurrency());
+    template<std::floating_point T>
+    bool parse_text(const char *first, const char *last, cyclic_tridiag<T> &mat, vector<T> &vec,
+                    std::size_t threads = std::thread::hardware_concurrency());
+}
+
+//class def
+namespace num
+{
+    //tridiagonal matrix with periodic corners: all diagonals have n entries, row i is
+    //a[i] * x[i - 1] + b[i] * x[i] + c[i] * x[i + 1] with x[0] = x[n] and x[n + 1] = x[1],
+    //so a[1] is the top right corner and c[n] is the bottom left one
+    template<std::floating_point T>
+    class cyclic_tridiag
+    {
+    public:
+        vector<T> a, b, c;
+
+        cyclic_tridiag(std::size_t size = 1, const T &value = 0);
+        cyclic_tridiag(vector<T> a,
+                       vector<T> b,
+                       vector<T> c);
+        cyclic_tridiag(std::size_t size, const T &min, const T &max);
+        cyclic_tridiag(std::size_t size,
+                       const T &min_a, const T &max_a,
+                       const T &min_b, const T &max_b,
+                       const T &min_c, const T &max_c);
+        cyclic_tridiag(std::size_t size,
+                       const T &min_a, const T &max_a,
+                       const T &min_b, const T &max_b,
+                       const T &min_c, const T &max_c,
+                       const random_key &key);
+
+        std::size_t size() const;
+
+        friend bool operator==<T>(const cyclic_tridiag &lhs, const cyclic_tridiag &rhs);
+        friend bool operator!=<T>(const cyclic_tridiag &lhs, const cyclic_tridiag &rhs);
+
+        friend vector<T> operator*<T>(const cyclic_tridiag &mat, const vector<T> &vec);
+
+        friend std::ostream &operator<<<T>(std::ostream &out, const cyclic_tridiag &mat);
+        friend std::istream &operator>><T>(std::istream &in, cyclic_tridiag &mat);
+    };
+
+    //read-only view of cyclic_tridiag coefficients in foreign memory, same layout: all diagonals from 1
+    template<std::floating_point T>
+    class cyclic_tridiag_view
+    {
+    public:
+        vector_view<const T> a, b, c;
+
+        cyclic_tridiag_view(vector_view<const T> a,
+                            vector_view<const T> b,
+                            vector_view<const T> c);
+        cyclic_tridiag_view(const cyclic_tridiag<T> &mat);
+
+        std::size_t size() const;
+    };
+}
+
+//func def
+namespace num
+{
+    template<std::floating_point T>
+    cyclic_tridiag<T>::cyclic_tridiag(std::size_t size, const T &value)
+        : a(size, value), b(size, value), c(size, value) {}
+
+    template<std::floating_point T>
+    cyclic_tridiag<T>::cyclic_tridiag(vector<T> a,
+                                      vector<T> b,
+                                      vector<T> c)
+        : a(std::move(a)), b(std::move(b)), c(std::move(c)) {}
+
+    template<std::floating_point T>
+    cyclic_tridiag<T>::cyclic_tridiag(std::size_t size, const T &min, const T &max)
+        : cyclic_tridiag(size, min, max, min, max, min, max) {}
+
+    template<std::floating_point T>
+    cyclic_tridiag<T>::cyclic_tridiag(std::size_t size,
+                                      const T &min_a, const T &max_a,
+                                      const T &min_b, const T &max_b,
+                                      const T &min_c, const T &max_c)
+        : cyclic_tridiag(size, min_a, max_a, min_b, max_b, min_c, max_c, random_key{ std::random_device()() }) {}
+
+    //a, b, c use streams key.stream, key.stream + 1, key.stream + 2
+    template<std::floating_point T>
+    cyclic_tridiag<T>::cyclic_tridiag(std::size_t size,
+                                      const T &min_a, const T &max_a,
+                                      const T &min_b, const T &max_b,
+                                      const T &min_c, const T &max_c,
+                                      const random_key &key)
+        : a(size, min_a, max_a, key),
+          b(size, min_b, max_b, random_key{ key.seed, key.stream + 1 }),
+          c(size, min_c, max_c, random_key{ key.seed, key.stream + 2 })
+          {}
+
+    template<std::floating_point T>
+    std::size_t cyclic_tridiag<T>::size() const
+    {
+        return b.size();
+    }
+
+    template<std::floating_point T>
+    cyclic_tridiag_view<T>::cyclic_tridiag_view(vector_view<const T> a,
+                                                vector_view<const T> b,
+                                                vector_view<const T> c)
+        : a(a), b(b), c(c) {}
+
+    template<std::floating_point T>
+    cyclic_tridiag_view<T>::cyclic_tridiag_view(const cyclic_tridiag<T> &mat)
+        : cyclic_tridiag_view(mat.a, mat.b, mat.c) {}
+
+    template<std::floating_point T>
+    std::size_t cyclic_tridiag_view<T>::size() const
+    {
+        return b.size();
+    }
+
+    template<std::floating_point T>
+    bool operator==(const cyclic_tridiag<T> &lhs, const cyclic_tridiag<T> &rhs)
+    {
+        return lhs.a == rhs.a && lhs.b == rhs.b && lhs.c == rhs.c;
+    }
+
+    template<std::floating_point T>
+    bool operator!=(const cyclic_tridiag<T> &lhs, const cyclic_tridiag<T> &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    //band part as for tridiag, then corners
+    template<std::floating_point T>
+    vector<T> operator*(const cyclic_tridiag<T> &mat, const vector<T> &vec)
+    {
+        std::size_t n = mat.size();
+        vector<T> res(n);
+        simd::matvec(mat.a.data() + 1, mat.b.data(), mat.c.data(), vec.data(), res.data(), n);
+        res[1] += mat.a[1] * vec[n];
+        res[n] += mat.c[n] * vec[1];
+        return res;
+    }
+
+    template<std::floating_point T>
+    std::ostream &operator<<(std::ostream &out, const cyclic_tridiag<T> &mat)
+    {
+        std::size_t n = mat.size();
+        auto mode = print_mode_of(out, n, true);
+        if (mode != print_mode::dense)
+        {
+            print_diagonal(out, "a", mat.a.data(), n, mode);
+            print_diagonal(out, "b", mat.b.data(), n, mode);
+            print_diagonal(out, "c", mat.c.data(), n, mode);
+            return out;
+        }
+
+        int places = format<T>(out);
+        for (std::size_t i = 1; i <= n; i++)
+        {
+            std::size_t prev = i > 1 ? i - 1 : n, next = i < n ? i + 1 : 1;
+            for (std::size_t j = 1; j <= n; j++)
+            {
+                T val = 0;
+                if (j == prev)
+                    val += mat.a[i];
+                if (j == i)
+                    val += mat.b[i];
+                if (j == next)
+                    val += mat.c[i];
+                out << std::setw(places) << val;
+            }
+            out << std::endl;
+        }
+        return out;
+    }
+
+    template<std::floating_point T>
+    std::istream &operator>>(std::istream &in, cyclic_tridiag<T> &mat)
+    {
+        return in >> mat.a >> mat.b >> mat.c;
+    }
+
+    //Sherman-Morrison: A = B + u * v^T with u = (gamma, 0, ..., 0, c[n]), v = (1, 0, ..., 0, a[1] / gamma),
+    //B is tridiagonal, so x = y - (v * y) / (1 + v * z) * z with B * y = d, B * z = u
+    template<std::floating_point T>
+    vector<T> cyclic_solve(const cyclic_tridiag<T> &mat, const vector<T> &vec)
+    {
+        return cyclic_solve(cyclic_tridiag_view<T>(mat), vector_view<const T>(vec));
+    }
+
+    template<std::floating_point T>
+    vector<T> cyclic_solve(const cyclic_tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec)
+    {
+        std::size_t n = mat.size();
+        if (n == 1)
+        {
+            vector<T> x(1);
+            x[1] = vec[vec.indexing] / (mat.a[1] + mat.b[1] + mat.c[1]);
+            return x;
+        }
+
+        T gamma = mat.b[1] != 0 ? -mat.b[1] : 1, alpha = mat.c[n], beta = mat.a[1];
+        tridiag<T> band(n);
+        for (std::size_t i = 1; i <= n; i++)
+        {
+            band.b[i] = mat.b[i];
+            if (i > 1)
+                band.a[i] = mat.a[i];
+            if (i < n)
+                band.c[i] = mat.c[i];
+        }
+        band.b[1] -= gamma;
+        band.b[n] -= alpha * beta / gamma;
+        thomas_factorization<T> factor(band);
+
+        vector<T> x(vec), z(n);
+        z[1] = gamma;
+        z[n] = alpha;
+        factor.solve(x);
+        factor.solve(z);
+
+        T k = (x[1] + beta * x[n] / gamma) / (1 + z[1] + beta * z[n] / gamma);
+        axpy(-k, z, x);
+        return x;
+    }
+
+    //text format: n, then a (n), b (n), c (n), d (n) separated by any whitespace
+    template<std::floating_point T>
+    bool parse_text(const std::string &path, cyclic_tridiag<T> &mat, vector<T> &vec, std::size_t threads)
+    {
+        std::string buffer;
+        return read_file(path, buffer) && parse_text(buffer.data(), buffer.data() + buffer.size(), mat, vec, threads);
+    }
+
+    template<std::floating_point T>
+    bool parse_text(const char *first, const char *last, cyclic_tridiag<T> &mat, vector<T> &vec, std::size_t threads)
+    {
+        std::size_t n;
+        if (!parse_size(first, last, n))
+            return false;
+
+        mat = cyclic_tridiag<T>(n);
+        vec = vector<T>(n);
+        T *targets[] = { mat.a.data(), mat.b.data(), mat.c.data(), vec.data() };
+        std::size_t sizes[] = { n, n, n, n };
+        return parse_arrays<T>(first, last, targets, sizes, threads);
+    }
+}
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "tridiag.h"
+#include "multivector.h"
+#include "view.h"
+#include "stats.h"
+
+//class / func decl (forward)
+namespace num
+{
+    template<std::floating_point T>
+    class thomas_factorization;
+
+    template<std::floating_point T>
+    T condition_estimate(const tridiag<T> &mat, const thomas_factorization<T> &factor);
+    template<std::floating_point T>
+    T condition_estimate(const tridiag<T> &mat);
+}
+
+//class def
+namespace num
+{
+    //Thomas algorithm coefficients of a fixed matrix, computed once:
+    //forward iteration M[i] = (d[i] - a[i] * M[i - 1]) * r[i], backward x[i] = M[i] - L[i] * x[i + 1]
+    template<std::floating_point T>
+    class thomas_factorization
+    {
+        std::vector<T> _a, _L, _r;
+
+    public:
+        //bytes of right-hand sides kept in cache between forward and backward iteration
+        static constexpr std::size_t cache_bytes = 1 << 18;
+
+        thomas_factorization(const tridiag<T> &mat);
+        thomas_factorization(const tridiag_view<T> &mat);
+
+        std::size_t size() const;
+
+        void solve(vector<T> &vec) const;
+        void solve(const vector_view<T> &vec) const;
+        void solve(multivector<T> &vecs) const;
+
+        void solve_transposed(vector<T> &vec) const;
+        void solve_transposed(const vector_view<T> &vec) const;
+    };
+}
+
+//func def
+namespace num
+{
+    template<std::floating_point T>
+    thomas_factorization<T>::thomas_factorization(const tridiag<T> &mat)
+        : thomas_factorization(tridiag_view<T>(mat)) {}
+
+    template<std::floating_point T>
+    thomas_factorization<T>::thomas_factorization(const tridiag_view<T> &mat)
+        : _a(mat.size()), _L(mat.size()), _r(mat.size())
+    {
+        NUM_STATS_PHASE(forward);
+        std::size_t n = mat.size();
+        NUM_STATS_MOVED(6 * n * sizeof(T));
+        _a[0] = 0;
+        _r[0] = 1 / mat.b[1];
+        _L[0] = n > 1 ? mat.c[1] * _r[0] : 0;
+        for (std::size_t i = 1; i < n; i++)
+        {
+            _a[i] = mat.a[i + 1];
+            _r[i] = 1 / (mat.b[i + 1] - _a[i] * _L[i - 1]);
+            _L[i] = i < n - 1 ? mat.c[i + 1] * _r[i] : 0;
+        }
+    }
+
+    template<std::floating_point T>
+    std::size_t thomas_factorization<T>::size() const
+    {
+        return _r.size();
+    }
+
+    template<std::floating_point T>
+    void thomas_factorization<T>::solve(vector<T> &vec) const
+    {
+        solve(vector_view<T>(vec));
+    }
+
+    template<std::floating_point T>
+    void thomas_factorization<T>::solve(const vector_view<T> &vec) const
+    {
+        std::size_t n = size();
+        auto d = vec.base();
+
+        //forward iteration
+        {
+            NUM_STATS_PHASE(forward);
+            NUM_STATS_MOVED(4 * n * sizeof(T));
+            d[0] *= _r[0];
+            for (std::size_t i = 1; i < n; i++)
+                d[i] = (d[i] - _a[i] * d[i - 1]) * _r[i];
+        }
+
+        //backward iteration
+        NUM_STATS_PHASE(backward);
+        NUM_STATS_MOVED(3 * n * sizeof(T));
+        for (std::size_t i = n - 1; i > 0; i--)
+            d[i - 1] -= _L[i - 1] * d[i];
+    }
+
+    template<std::floating_point T>
+    void thomas_factorization<T>::solve(multivector<T> &vecs) const
+    {
+        std::size_t n = size(), count = vecs.count();
+
+        //columns are swept in blocks small enough to stay in cache for backward iteration
+        std::size_t block = std::max<std::size_t>(8, cache_bytes / (n * sizeof(T)) / 8 * 8);
+        for (std::size_t first = 0; first < count; first += block)
+        {
+            std::size_t last = std::min(first + block, count);
+
+            //forward iteration
+            {
+                T *d = vecs[vecs.indexing];
+                for (std::size_t k = first; k < last; k++)
+                    d[k] *= _r[0];
+            }
+            for (std::size_t i = 1; i < n; i++)
+            {
+                const T *prev = vecs[i - 1 + vecs.indexing];
+                T *d = vecs[i + vecs.indexing];
+                T a = _a[i], r = _r[i];
+                for (std::size_t k = first; k < last; k++)
+                    d[k] = (d[k] - a * prev[k]) * r;
+            }
+
+            //backward iteration
+            for (std::size_t i = n - 1; i > 0; i--)
+            {
+                const T *next = vecs[i + vecs.indexing];
+                T *d = vecs[i - 1 + vecs.indexing];
+                T L = _L[i - 1];
+                for (std::size_t k = first; k < last; k++)
+                    d[k] -= L * next[k];
+            }
+        }
+    }
+
+    template<std::floating_point T>
+    void thomas_factorization<T>::solve_transposed(vector<T> &vec) const
+    {
+        solve_transposed(vector_view<T>(vec));
+    }
+
+    //A = L * U with L lower bidiagonal (1 / r[i] on the diagonal, a[i] below), U unit upper bidiagonal (L[i] above),
+    //so A^T * x = d is U^T * w = d forward, then L^T * x = w backward
+    template<std::floating_point T>
+    void thomas_factorization<T>::solve_transposed(const vector_view<T> &vec) const
+    {
+        std::size_t n = size();
+        auto d = vec.base();
+
+        //forward iteration
+        for (std::size_t i = 1; i < n; i++)
+            d[i] -= _L[i - 1] * d[i - 1];
+
+        //backward iteration
+        d[n - 1] *= _r[n - 1];
+        for (std::size_t i = n - 1; i > 0; i--)
+            d[i - 1] = (d[i - 1] - _a[i] * d[i]) * _r[i - 1];
+    }
+
+    //estimate of cond(A) = ||A||_1 * ||A^-1||_1 in O(n), a lower bound that is rarely off by more than a factor of 3:
+    //||A^-1||_1 by Hager's method with Higham's refinements (as LAPACK xLACN2), every step one solve with factor
+    //or its transpose. Infinite or NaN if the factorization broke down
+    template<std::floating_point T>
+    T condition_estimate(const tridiag<T> &mat, const thomas_factorization<T> &factor)
+    {
+        constexpr std::size_t max_steps = 5;
+        std::size_t n = mat.size();
+
+        T norm = 0;
+        for (std::size_t j = 1; j <= n; j++)
+        {
+            T col = std::abs(mat.b[j]);
+            if (j > 1)
+                col += std::abs(mat.c[j - 1]);
+            if (j < n)
+                col += std::abs(mat.a[j + 1]);
+            norm = std::max(norm, col);
+        }
+
+        auto norm_1 = [](const vector<T> &x)
+        {
+            T res = 0;
+            for (std::size_t i = 0; i < x.size(); i++)
+                res += std::abs(x.data()[i]);
+            return res;
+        };
+        //x = sign(v), true if that changed nothing
+        auto sign = [](const vector<T> &v, vector<T> &x)
+        {
+            bool same = true;
+            for (std::size_t i = 0; i < v.size(); i++)
+            {
+                T s = v.data()[i] >= 0 ? 1 : -1;
+                same = same && s == x.data()[i];
+                x.data()[i] = s;
+            }
+            return same;
+        };
+        auto arg_max = [](const vector<T> &x)
+        {
+            std::size_t res = 0;
+            for (std::size_t i = 1; i < x.size(); i++)
+                if (std::abs(x.data()[i]) > std::abs(x.data()[res]))
+                    res = i;
+            return res;
+        };
+
+        //A^-1 applied to (1 / n, ..., 1 / n) and then to unit vectors e[j] where A^-T * sign(A^-1 * x) peaks
+        vector<T> v(n, T(1) / n), x(n, 0);
+        factor.solve(v);
+        T est = norm_1(v);
+        if (n > 1 && std::isfinite(est))
+        {
+            sign(v, x);
+            factor.solve_transposed(x);
+            std::size_t j = arg_max(x);
+            for (std::size_t step = 2; step <= max_steps; step++)
+            {
+                std::fill_n(v.data(), n, 0);
+                v.data()[j] = 1;
+                factor.solve(v);
+                T prev = est;
+                est = norm_1(v);
+                if (!(est > prev))
+                {
+                    est = prev;
+                    break;
+                }
+                if (sign(v, x))
+                    break;
+                factor.solve_transposed(x);
+                //as dlacn2: stop when the previous index still peaks, its value compared with sign
+                std::size_t last = j;
+                j = arg_max(x);
+                if (x.data()[last] == std::abs(x.data()[j]))
+                    break;
+            }
+
+            //alternative estimate that catches matrices where the sign vectors mislead the iteration
+            for (std::size_t i = 0; i < n; i++)
+                v.data()[i] = (i % 2 ? -1 : 1) * (1 + T(i) / (n - 1));
+            factor.solve(v);
+            est = std::max(est, 2 * norm_1(v) / (3 * n));
+        }
+        return norm * est;
+    }
+
+    template<std::floating_point T>
+    T condition_estimate(const tridiag<T> &mat)
+    {
+        return condition_estimate(mat, thomas_factorization<T>(mat));
+    }
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <array>
+#include <utility>
+#include <stdexcept>
+
+#include "tridiag.h"
+
+//class / func decl (forward)
+namespace num
+{
+    template<std::floating_point T, std::size_t N, std::size_t I = 1>
+    class vector_fixed;
+    template<std::floating_point T, std::size_t N>
+    class tridiag_fixed;
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    constexpr bool operator==(const vector_fixed<T, N, I> &lhs, const vector_fixed<T, N, I> &rhs);
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    constexpr bool operator!=(const vector_fixed<T, N, I> &lhs, const vector_fixed<T, N, I> &rhs);
+    template<std::floating_point T, std::size_t N>
+    constexpr bool operator==(const tridiag_fixed<T, N> &lhs, const tridiag_fixed<T, N> &rhs);
+    template<std::floating_point T, std::size_t N>
+    constexpr bool operator!=(const tridiag_fixed<T, N> &lhs, const tridiag_fixed<T, N> &rhs);
+
+    template<std::floating_point T, std::size_t N>
+    constexpr vector_fixed<T, N> operator*(const tridiag_fixed<T, N> &mat, const vector_fixed<T, N> &vec);
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    std::ostream &operator<<(std::ostream &out, const vector_fixed<T, N, I> &vec);
+    template<std::floating_point T, std::size_t N>
+    std::ostream &operator<<(std::ostream &out, const tridiag_fixed<T, N> &mat);
+
+    template<std::floating_point T, std::size_t N>
+    constexpr vector_fixed<T, N> thomas_alg(const tridiag_fixed<T, N> &mat, const vector_fixed<T, N> &vec);
+}
+
+//class def
+namespace num
+{
+    //vector of N values on the stack, indexing I is fixed at compile time
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    class vector_fixed
+    {
+        std::array<T, N> _values{};
+
+    public:
+        static constexpr std::size_t indexing = I;
+
+        constexpr vector_fixed(const T &value = 0);
+        constexpr vector_fixed(const std::array<T, N> &values);
+        explicit vector_fixed(const vector<T> &vec);    //std::length_error unless vec.size() == N
+
+        constexpr T &operator[](std::size_t pos);
+        constexpr const T &operator[](std::size_t pos) const;
+
+        constexpr T *data();
+        constexpr const T *data() const;
+        constexpr std::size_t size() const;
+
+        operator vector<T>() const;
+
+        friend constexpr bool operator==<T, N, I>(const vector_fixed &lhs, const vector_fixed &rhs);
+        friend constexpr bool operator!=<T, N, I>(const vector_fixed &lhs, const vector_fixed &rhs);
+    };
+
+    //tridiag of compile time size N with stack storage, same 1-based layout as tridiag
+    template<std::floating_point T, std::size_t N>
+    class tridiag_fixed
+    {
+        static_assert(N > 0);
+
+    public:
+        vector_fixed<T, N - 1, 2> a;
+        vector_fixed<T, N> b;
+        vector_fixed<T, N - 1> c;
+
+        constexpr tridiag_fixed(const T &value = 0);
+        constexpr tridiag_fixed(const vector_fixed<T, N - 1, 2> &a,
+                                const vector_fixed<T, N> &b,
+                                const vector_fixed<T, N - 1> &c);
+        explicit tridiag_fixed(const tridiag<T> &mat);
+
+        constexpr std::size_t size() const;
+
+        operator tridiag<T>() const;
+
+        friend constexpr bool operator==<T, N>(const tridiag_fixed &lhs, const tridiag_fixed &rhs);
+        friend constexpr bool operator!=<T, N>(const tridiag_fixed &lhs, const tridiag_fixed &rhs);
+    };
+}
+
+//func def
+namespace num
+{
+    //calls func(0), ..., func(N - 1) as separate statements, so the loop is unrolled at compile time
+    template<std::size_t N, typename F>
+    constexpr void unroll(F &&func)
+    {
+        [&]<std::size_t... i>(std::index_sequence<i...>)
+        {
+            (func(i), ...);
+        }(std::make_index_sequence<N>());
+    }
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    constexpr vector_fixed<T, N, I>::vector_fixed(const T &value)
+    {
+        _values.fill(value);
+    }
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    constexpr vector_fixed<T, N, I>::vector_fixed(const std::array<T, N> &values)
+        : _values(values) {}
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    vector_fixed<T, N, I>::vector_fixed(const vector<T> &vec)
+    {
+        if (vec.size() != N)
+            throw std::length_error("vector_fixed: size of vector differs from N");
+        std::copy_n(vec.data(), N, _values.data());
+    }
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    constexpr T &vector_fixed<T, N, I>::operator[](std::size_t pos)
+    {
+        return _values[pos - I];
+    }
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    constexpr const T &vector_fixed<T, N, I>::operator[](std::size_t pos) const
+    {
+        return _values[pos - I];
+    }
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    constexpr T *vector_fixed<T, N, I>::data()
+    {
+        return _values.data();
+    }
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    constexpr const T *vector_fixed<T, N, I>::data() const
+    {
+        return _values.data();
+    }
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    constexpr std::size_t vector_fixed<T, N, I>::size() const
+    {
+        return N;
+    }
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    vector_fixed<T, N, I>::operator vector<T>() const
+    {
+        vector<T> res(N, 0, int(I));
+        std::ranges::copy(_values, res.data());
+        return res;
+    }
+
+    template<std::floating_point T, std::size_t N>
+    constexpr tridiag_fixed<T, N>::tridiag_fixed(const T &value)
+        : a(value), b(value), c(value) {}
+
+    template<std::floating_point T, std::size_t N>
+    constexpr tridiag_fixed<T, N>::tridiag_fixed(const vector_fixed<T, N - 1, 2> &a,
+                                                 const vector_fixed<T, N> &b,
+                                                 const vector_fixed<T, N - 1> &c)
+        : a(a), b(b), c(c) {}
+
+    template<std::floating_point T, std::size_t N>
+    tridiag_fixed<T, N>::tridiag_fixed(const tridiag<T> &mat)
+        : a(mat.a), b(mat.b), c(mat.c) {}
+
+    template<std::floating_point T, std::size_t N>
+    constexpr std::size_t tridiag_fixed<T, N>::size() const
+    {
+        return N;
+    }
+
+    template<std::floating_point T, std::size_t N>
+    tridiag_fixed<T, N>::operator tridiag<T>() const
+    {
+        return tridiag<T>(a, b, c);
+    }
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    constexpr bool operator==(const vector_fixed<T, N, I> &lhs, const vector_fixed<T, N, I> &rhs)
+    {
+        return lhs._values == rhs._values;
+    }
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    constexpr bool operator!=(const vector_fixed<T, N, I> &lhs, const vector_fixed<T, N, I> &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<std::floating_point T, std::size_t N>
+    constexpr bool operator==(const tridiag_fixed<T, N> &lhs, const tridiag_fixed<T, N> &rhs)
+    {
+        return lhs.a == rhs.a && lhs.b == rhs.b && lhs.c == rhs.c;
+    }
+
+    template<std::floating_point T, std::size_t N>
+    constexpr bool operator!=(const tridiag_fixed<T, N> &lhs, const tridiag_fixed<T, N> &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<std::floating_point T, std::size_t N>
+    constexpr vector_fixed<T, N> operator*(const tridiag_fixed<T, N> &mat, const vector_fixed<T, N> &vec)
+    {
+        vector_fixed<T, N> res;
+        unroll<N>([&](std::size_t k)
+        {
+            std::size_t i = k + 1;
+            res[i] = mat.b[i] * vec[i];
+            if (i > 1)
+                res[i] += mat.a[i] * vec[i - 1];
+            if (i < N)
+                res[i] += mat.c[i] * vec[i + 1];
+        });
+        return res;
+    }
+
+    template<std::floating_point T, std::size_t N, std::size_t I>
+    std::ostream &operator<<(std::ostream &out, const vector_fixed<T, N, I> &vec)
+    {
+        return out << vector<T>(vec);
+    }
+
+    template<std::floating_point T, std::size_t N>
+    std::ostream &operator<<(std::ostream &out, const tridiag_fixed<T, N> &mat)
+    {
+        return out << tridiag<T>(mat);
+    }
+
+    //same recurrence as thomas_alg for tridiag, both sweeps unrolled
+    template<std::floating_point T, std::size_t N>
+    constexpr vector_fixed<T, N> thomas_alg(const tridiag_fixed<T, N> &mat, const vector_fixed<T, N> &vec)
+    {
+        vector_fixed<T, N> x = vec, L;
+
+        //forward iteration
+        T r = 1 / mat.b[1];
+        x[1] *= r;
+        if constexpr (N > 1)
+            L[1] = mat.c[1] * r;
+        unroll<N - 1>([&](std::size_t k)
+        {
+            std::size_t i = k + 2;
+            r = 1 / (mat.b[i] - mat.a[i] * L[i - 1]);
+            x[i] = (x[i] - mat.a[i] * x[i - 1]) * r;
+            if (i < N)
+                L[i] = mat.c[i] * r;
+        });
+
+        //backward iteration
+        unroll<N - 1>([&](std::size_t k)
+        {
+            std::size_t i = N - 1 - k;
+            x[i] -= L[i] * x[i + 1];
+        });
+        return x;
+    }
+}
@@ -4,12 +4,80 @@
 #include <iomanip>
 #include <limits>
 #include <concepts>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <cmath>
+#include <algorithm>
 
-//func decl
+//class / func decl (forward)
 namespace num
 {
+    //how matrices and vectors are printed by operator<<, kept per stream
+    enum class print_mode : long
+    {
+        automatic,  //dense up to dense_rows rows, then summary for matrices; aligned up to aligned_values, then plain for vectors
+        dense,      //matrices in full n x n, vectors aligned in columns
+        diagonals,  //matrices as their diagonals, one aligned line each
+        summary,    //diagonals and vectors cut to their first and last edge values
+        plain       //every value in shortest exact form through text_writer, no alignment
+    };
+
+    inline constexpr std::size_t dense_rows = 16, aligned_values = 1000, summary_edge = 3;
+
+    struct print_as;
+    class text_writer;
+
     template<std::floating_point T>
     std::size_t format(std::ostream& out, bool left = true);
+
+    std::ostream &operator<<(std::ostream &out, const print_as &manip);
+    print_mode print_mode_of(std::ostream &out, std::size_t size, bool matrix);
+
+    template<typename T>
+    void print_values(std::ostream &out, const T *data, std::size_t size, std::ptrdiff_t stride, print_mode mode);
+    template<typename T>
+    void print_diagonal(std::ostream &out, const char *name, const T *data, std::size_t size, print_mode mode);
+}
+
+//class def
+namespace num
+{
+    //manipulator: out << num::print_as{ num::print_mode::summary, 5 }
+    struct print_as
+    {
+        print_mode mode;
+        std::size_t edge = summary_edge;    //0 for the default
+    };
+
+    //buffered text output through to_chars, values in shortest form that reads back exactly;
+    //the buffer goes to the stream when full, on flush() and on destruction
+    class text_writer
+    {
+        std::ostream &_out;
+        std::string _buffer;
+        std::size_t _used = 0;
+
+        char *reserve(std::size_t size);
+
+    public:
+        static constexpr std::size_t max_value = 32;    //characters of the longest value
+
+        explicit text_writer(std::ostream &out, std::size_t capacity = 1 << 20);
+        text_writer(const text_writer &other) = delete;
+        text_writer &operator=(const text_writer &other) = delete;
+        ~text_writer();
+
+        template<typename T>
+        requires std::floating_point<T> || std::integral<T>
+        text_writer &write(const T &value);
+        template<typename T>
+        text_writer &write(const T *data, std::size_t size, std::ptrdiff_t stride = 1);
+        text_writer &write(char ch);
+        text_writer &write(std::string_view text);
+
+        void flush();
+    };
 }
 
 //func def
@@ -23,4 +91,140 @@ namespace num
         out << std::scientific << std::setprecision(digits) << (left ? std::left : std::right) << std::showpos << std::setfill(' ');
         return places;
     }
+
+    namespace format_detail
+    {
+        inline int mode_index()
+        {
+            static int res = std::ios_base::xalloc();
+            return res;
+        }
+
+        inline int edge_index()
+        {
+            static int res = std::ios_base::xalloc();
+            return res;
+        }
+    }
+
+    inline std::ostream &operator<<(std::ostream &out, const print_as &manip)
+    {
+        out.iword(format_detail::mode_index()) = long(manip.mode);
+        out.iword(format_detail::edge_index()) = long(manip.edge);
+        return out;
+    }
+
+    //mode of out for an object of size rows (matrix) or values (vector), automatic resolved;
+    //vectors have no diagonals and are printed aligned instead
+    inline print_mode print_mode_of(std::ostream &out, std::size_t size, bool matrix)
+    {
+        auto mode = print_mode(out.iword(format_detail::mode_index()));
+        if (mode == print_mode::automatic)
+        {
+            if (matrix)
+                return size <= dense_rows ? print_mode::dense : print_mode::summary;
+            return size <= aligned_values ? print_mode::dense : print_mode::plain;
+        }
+        if (!matrix && mode == print_mode::diagonals)
+            return print_mode::dense;
+        return mode;
+    }
+
+    //one line of values without the line break; dense and diagonals align them as format does
+    template<typename T>
+    void print_values(std::ostream &out, const T *data, std::size_t size, std::ptrdiff_t stride, print_mode mode)
+    {
+        if (mode == print_mode::plain)
+        {
+            text_writer writer(out, std::min<std::size_t>(1 << 20, (size + 1) * text_writer::max_value));
+            writer.write(data, size, stride);
+            return;
+        }
+
+        int places = format<T>(out);
+        std::size_t edge = out.iword(format_detail::edge_index());
+        if (edge == 0)
+            edge = summary_edge;
+        if (mode != print_mode::summary || size <= 2 * edge)
+            edge = size;
+        for (std::size_t i = 0; i < edge; i++)
+            out << std::setw(places) << data[std::ptrdiff_t(i) * stride];
+        if (edge == size)
+            return;
+        out << "... (" << std::noshowpos << size - 2 * edge << " more) ...  " << std::showpos;
+        for (std::size_t i = size - edge; i < size; i++)
+            out << std::setw(places) << data[std::ptrdiff_t(i) * stride];
+    }
+
+    template<typename T>
+    void print_diagonal(std::ostream &out, const char *name, const T *data, std::size_t size, print_mode mode)
+    {
+        out << name << ": ";
+        print_values(out, data, size, 1, mode);
+        out << std::endl;
+    }
+
+    inline text_writer::text_writer(std::ostream &out, std::size_t capacity)
+        : _out(out), _buffer(std::max(capacity, 2 * max_value), '\0') {}
+
+    inline text_writer::~text_writer()
+    {
+        flush();
+    }
+
+    inline char *text_writer::reserve(std::size_t size)
+    {
+        if (_used + size > _buffer.size())
+            flush();
+        return _buffer.data() + _used;
+    }
+
+    template<typename T>
+    requires std::floating_point<T> || std::integral<T>
+    text_writer &text_writer::write(const T &value)
+    {
+        char *pos = reserve(max_value);
+        _used = std::to_chars(pos, pos + max_value, value).ptr - _buffer.data();
+        return *this;
+    }
+
+    //values separated by single spaces
+    template<typename T>
+    text_writer &text_writer::write(const T *data, std::size_t size, std::ptrdiff_t stride)
+    {
+        for (std::size_t i = 0; i < size; i++)
+        {
+            char *pos = reserve(max_value + 1);
+            if (i > 0)
+                *pos++ = ' ';
+            _used = std::to_chars(pos, pos + max_value, data[std::ptrdiff_t(i) * stride]).ptr - _buffer.data();
+        }
+        return *this;
+    }
+
+    inline text_writer &text_writer::write(char ch)
+    {
+        *reserve(1) = ch;
+        _used++;
+        return *this;
+    }
+
+    inline text_writer &text_writer::write(std::string_view text)
+    {
+        if (text.size() > _buffer.size())
+        {
+            flush();
+            _out.write(text.data(), text.size());
+            return *this;
+        }
+        text.copy(reserve(text.size()), text.size());
+        _used += text.size();
+        return *this;
+    }
+
+    inline void text_writer::flush()
+    {
+        _out.write(_buffer.data(), _used);
+        _used = 0;
+    }
 }
@@ -1,33 +1,119 @@
 #include <fstream>
 #include <string>
+#include <chrono>
+#include <array>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <iterator>
+#include <filesystem>
+#include <charconv>
+#include <optional>
 
 #include "tridiag.h"
 #include "solve.h"
+#include "batch.h"
+#include "factorization.h"
+#include "pcr.h"
+#include "partition.h"
+#include "mixed.h"
+#include "cyclic.h"
+#include "block.h"
+#include "binary.h"
+#include "stream.h"
+#include "parse.h"
+#include "thread_pool.h"
+#include "queue.h"
+#include "server.h"
 
 using real = double;
 
-bool from_file(num::tridiag<real> &mat, num::vector<real> &vec, const std::string &what)
+template<typename F>
+auto timed(real &seconds, F &&func)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto res = func();
+    seconds = std::chrono::duration<real>(std::chrono::steady_clock::now() - start).count();
+    return res;
+}
+
+//statistics of solver phases inside func, collected only when built with NUM_STATS
+template<typename F>
+auto profiled(num::stats::report &report, F &&func)
+{
+    num::stats::reset();
+    auto res = [&]()
+    {
+        num::stats::perf_scope perf;
+        return func();
+    }();
+    report = num::stats::snapshot();
+    return res;
+}
+
+template<typename M>
+bool from_text(const std::string &path, M &mat, num::vector<real> &vec)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+    {
+        std::cout << "File does not exist. Return to main menu." << std::endl << std::endl;
+        return false;
+    }
+    real megabytes = in.tellg() / 1e6;
+    in.close();
+
+    real seconds;
+    if (!timed(seconds, [&]() { return num::parse_text(path, mat, vec); }))
+    {
+        std::cout << "File is not a valid system. Return to main menu." << std::endl << std::endl;
+        return false;
+    }
+    std::cout << std::defaultfloat << std::noshowpos
+              << "Parsed " << megabytes << " MB at " << megabytes / seconds << " MB/s." << std::endl;
+    return true;
+}
+
+std::string file_path()
 {
     std::cout << "Enter file path: ";
     std::string path;
     std::cin.ignore();
     std::getline(std::cin, path);
-    std::ifstream in(path);
     std::cout << std::endl;
+    return path;
+}
 
-    if (!in.is_open())
+bool from_file(num::tridiag<real> &mat, num::vector<real> &vec, const std::string &what)
+{
+    std::string path = file_path();
+    if (num::is_binary(path))
     {
-        std::cout << "File does not exist. Return to main menu." << std::endl << std::endl;
-        return false;
+        num::mapped_system<real> sys;
+        if (!sys.open(path))
+        {
+            std::cout << "Binary file is invalid or of other precision. Return to main menu." << std::endl << std::endl;
+            return false;
+        }
+        mat = sys.matrix();
+        vec = sys.rhs();
     }
+    else if (!from_text(path, mat, vec))
+        return false;
 
-    std::size_t n;
-    in >> n;
-    mat = num::tridiag<real>(n);
-    vec = num::vector<real>(n);
-    in >> mat >> vec;
+    std::cout << "Values successfully read from file." << std::endl << std::endl
+              << "Matrix [[A]] is:" << std::endl << mat << std::endl
+              << "Vector [" << what << "] is:" << std::endl << vec << std::endl;
+    return true;
+}
+
+//text only: n, then a (n), b (n), c (n) and vector (n)
+bool from_file(num::cyclic_tridiag<real> &mat, num::vector<real> &vec, const std::string &what)
+{
+    if (!from_text(file_path(), mat, vec))
+        return false;
 
-    in.close();
     std::cout << "Values successfully read from file." << std::endl << std::endl
               << "Matrix [[A]] is:" << std::endl << mat << std::endl
               << "Vector [" << what << "] is:" << std::endl << vec << std::endl;
@@ -50,7 +136,32 @@ void limits(real &min_a, real &max_a, real &min_b, real &max_b, real &min_c, rea
     std::cout << std::endl;
 }
 
-bool random(num::tridiag<real> &mat, num::vector<real> &vec, const std::string &what)
+//a number or - for a random one; asked again until it parses, false only when input ends
+bool read_seed(num::random_key &key)
+{
+    std::string text;
+    while (std::cout << "Enter seed (- for random): " && std::cin >> text)
+    {
+        std::cout << std::endl;
+        if (text == "-")
+        {
+            key = num::random_key{ std::random_device()() };
+            return true;
+        }
+        std::uint64_t seed;
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), seed);
+        if (ec == std::errc() && ptr == text.data() + text.size())
+        {
+            key = num::random_key{ seed };
+            return true;
+        }
+        std::cout << "Seed is not a non-negative integer of at most 64 bits." << std::endl << std::endl;
+    }
+    return false;
+}
+
+template<typename M>
+bool random(M &mat, num::vector<real> &vec, const std::string &what)
 {
     std::cout << "Enter system size: ";
     std::size_t n;
@@ -66,8 +177,11 @@ bool random(num::tridiag<real> &mat, num::vector<real> &vec, const std::string &
     real min_a, max_a, min_b, max_b, min_c, max_c, min, max;
     limits(min_a, max_a, min_b, max_b, min_c, max_c, min, max, what);
 
-    mat = num::tridiag<real>(n, min_a, max_a, min_b, max_b, min_c, max_c);
-    vec = num::vector<real>(n, min, max);
+    num::random_key key;
+    if (!read_seed(key))
+        return false;
+    mat = M(n, min_a, max_a, min_b, max_b, min_c, max_c, key);
+    vec = num::vector<real>(n, min, max, num::random_key{ key.seed, 3 });
 
     std::cout << "Values successfully randomized." << std::endl << std::endl
               << "Matrix [[A]] is:" << std::endl << mat << std::endl
@@ -75,7 +189,8 @@ bool random(num::tridiag<real> &mat, num::vector<real> &vec, const std::string &
     return true;
 }
 
-bool fill(num::tridiag<real> &mat, num::vector<real> &vec, const std::string &what)
+template<typename M>
+bool fill(M &mat, num::vector<real> &vec, const std::string &what)
 {
     int choice;
     std::cout << "Select fill method:" << std::endl
@@ -122,88 +237,785 @@ bool fill(num::tridiag<real> &mat, num::vector<real> &vec, const std::string &wh
 void solution_mode()
 {
     num::tridiag<real> mat;
-    num::vector<real> vec, thomas, unstable;
+    num::vector<real> vec, thomas, unstable, partition;
 
     if (!fill(mat, vec, "d"))
         return;
 
     thomas = num::thomas_alg(mat, vec);
     unstable = num::unstable_method(mat, vec);
+    partition = num::partition_solve(mat, vec);
 
     std::cout << "Result vector [x] from Thomas algorithm is:" << std::endl << thomas << std::endl
               << "Result vector [x] from unstable method is:" << std::endl << unstable << std::endl
-              << "Result difference norm ||[x]T - [x]u|| is: " << (thomas - unstable).norm() << std::endl << std::endl;
+              << "Result difference norm ||[x]T - [x]u|| is: " << (thomas - unstable).norm() << std::endl
+              << "Result difference norm ||[x]T - [x]p|| (partition solver) is: " << (thomas - partition).norm() << std::endl << std::endl;
 }
 
 void test_mode()
 {
     num::tridiag<real> mat;
-    num::vector<real> vec, exact, thomas, unstable;
+    num::vector<real> vec, exact, thomas, unstable, mixed, pivot;
 
     if (!fill(mat, exact, "x*"))
         return;
 
     vec = mat * exact;
-    thomas = num::thomas_alg(mat, vec);
-    unstable = num::unstable_method(mat, vec);
+    num::stats::report thomas_stats, unstable_stats;
+    //the factorization of the solve is kept for the condition estimate below
+    std::optional<num::thomas_factorization<real>> factor;
+    thomas = profiled(thomas_stats, [&]()
+    {
+        factor.emplace(mat);
+        num::vector<real> x = vec;
+        factor->solve(x);
+        return x;
+    });
+    unstable = profiled(unstable_stats, [&]() { return num::unstable_method(mat, vec); });
+    auto refinement = num::solve_mixed(mat, vec, mixed);
+    pivot = num::pivot_solve(mat, vec);
 
     std::cout << "Vector [d] = [[A]] * [x*] is:" << std::endl << vec << std::endl
               << "Result vector [x] from Thomas algorithm is:" << std::endl << thomas
               << "Thomas algorithm error ||[x*] - [x]|| is: " << (exact - thomas).norm() << std::endl << std::endl
               << "Result vector [x] from unstable method is:" << std::endl << unstable
-              << "Unstable method error ||[x*] - [x]|| is: " << (exact - unstable).norm() << std::endl << std::endl;
+              << "Unstable method error ||[x*] - [x]|| is: " << (exact - unstable).norm() << std::endl << std::endl
+              << "Mixed precision error ||[x*] - [x]|| is: " << (exact - mixed).norm()
+              << " (" << refinement.iterations << " refinement steps"
+              << (refinement.fallback ? ", fell back to double solve" : "") << ")" << std::endl
+              << "Pivoting LU error ||[x*] - [x]|| is: " << (exact - pivot).norm() << std::endl
+              << "Matrix is " << (num::diagonally_dominant(mat) ? "" : "not ")
+              << "diagonally dominant, num::solve takes the "
+              << (num::diagonally_dominant(mat) ? "Thomas" : "pivoting") << " path." << std::endl << std::endl;
+
+    auto residual = num::residual(mat, thomas, vec);
+    real condition = num::condition_estimate(mat, *factor);
+    std::cout << "Thomas algorithm residual ||[[A]] * [x] - [d]|| is: " << residual.inf
+              << " (2-norm " << residual.two << ")" << std::endl
+              << "Condition number estimate cond([[A]]) in 1-norm is: " << condition << std::endl
+              << "Relative error expected from conditioning cond([[A]]) * eps is: "
+              << condition * std::numeric_limits<real>::epsilon() << std::endl << std::endl;
+
+    if constexpr (num::stats::enabled())
+        std::cout << "Thomas algorithm statistics:" << std::endl << thomas_stats << std::endl
+                  << "Unstable method statistics:" << std::endl << unstable_stats << std::endl;
 }
 
-void error_table()
+void cyclic_mode()
 {
-    auto sizes = { 10, 50, 100, 500, 1000, 5000, 10000, 50000, 100000, 500000, 1000000 };
+    num::cyclic_tridiag<real> mat;
+    num::vector<real> vec, exact, x;
 
-    std::string head_thomas = "Thomas algorithm ERROR",
-                head_unstable = "Unstable method ERROR",
-                sep = " | ";
+    if (!fill(mat, exact, "x*"))
+        return;
+
+    vec = mat * exact;
+    x = num::cyclic_solve(mat, vec);
+
+    std::cout << "Vector [d] = [[A]] * [x*] is:" << std::endl << vec << std::endl
+              << "Result vector [x] from Sherman-Morrison method is:" << std::endl << x
+              << "Sherman-Morrison method error ||[x*] - [x]|| is: " << (exact - x).norm() << std::endl
+              << "Residual ||[[A]] * [x] - [d]|| is: " << (mat * x - vec).norm() << std::endl << std::endl;
+}
+
+template<std::size_t B>
+void block_test(std::size_t n, const std::array<real, 8> &range, const num::random_key &key)
+{
+    num::block_tridiag<real, B> mat(n, range[0], range[1], range[2], range[3], range[4], range[5], key);
+    num::vector<real> exact(n * B, range[6], range[7], num::random_key{ key.seed, 3 });
+    auto vec = mat * exact;
+
+    real seconds;
+    auto x = timed(seconds, [&]() { return num::block_thomas(mat, vec); });
+    num::format<real>(std::cout);
+    std::cout << "Block Thomas algorithm error ||[x*] - [x]|| is: " << (exact - x).norm() << std::endl
+              << "Residual ||[[A]] * [x] - [d]|| is: " << (mat * x - vec).norm() << std::endl
+              << std::defaultfloat << std::noshowpos << "Solved in " << seconds << " s." << std::endl << std::endl;
+}
+
+void block_mode()
+{
+    std::size_t n, block;
+    std::cout << "Enter block count and block size (2, 3, 4, 6 or 8): ";
+    std::cin >> n >> block;
+    std::cout << std::endl;
+    if (n < 1)
+    {
+        std::cout << "Size less than 1. Return to main menu." << std::endl << std::endl;
+        return;
+    }
+    if (block != 2 && block != 3 && block != 4 && block != 6 && block != 8)
+    {
+        std::cout << "Unsupported block size. Return to main menu." << std::endl << std::endl;
+        return;
+    }
+
+    std::array<real, 8> range;
+    limits(range[0], range[1], range[2], range[3], range[4], range[5], range[6], range[7], "x*");
+
+    num::random_key key;
+    if (!read_seed(key))
+        return;
+
+    switch (block)
+    {
+        case 2:
+            return block_test<2>(n, range, key);
+        case 3:
+            return block_test<3>(n, range, key);
+        case 4:
+            return block_test<4>(n, range, key);
+        case 6:
+            return block_test<6>(n, range, key);
+        default:
+            return block_test<8>(n, range, key);
+    }
+}
+
+void print_table(const std::vector<std::size_t> &sizes, const std::vector<std::string> &heads,
+                 const std::vector<std::vector<real>> &rows)
+{
+    std::string sep = " | ";
 
     auto places = num::format<real>(std::cout, false);
-    std::size_t width_size = std::log10(std::numeric_limits<std::size_t>::max()) + 1,
-                width_thomas = std::max(places, head_thomas.size()),
-                width_unstable = std::max(places, head_unstable.size());
+    std::size_t width_size = std::log10(std::numeric_limits<std::size_t>::max()) + 1;
+    std::vector<std::size_t> widths;
+    for (auto &head : heads)
+        widths.push_back(std::max(places, head.size()));
+
+    std::cout << std::setw(width_size) << "SIZE";
+    for (std::size_t j = 0; j < heads.size(); j++)
+        std::cout << sep << std::setw(widths[j]) << heads[j];
+    std::cout << std::endl;
+
+    std::cout << std::setfill('_') << ' '
+              << std::setw(width_size + 1) << "|";
+    for (std::size_t j = 0; j + 1 < heads.size(); j++)
+        std::cout << std::setw(widths[j] + 3) << "|";
+    std::cout << std::setw(widths.back() + 1) << "_" << std::endl;
+
+    std::cout << std::setfill(' ')
+              << std::setw(width_size + 3) << sep;
+    for (std::size_t j = 0; j + 1 < heads.size(); j++)
+        std::cout << std::setw(widths[j] + 3) << sep;
+    std::cout << std::endl;
+
+    for (std::size_t i = 0; i < sizes.size(); i++)
+    {
+        std::cout << std::setw(width_size) << sizes[i];
+        for (std::size_t j = 0; j < rows[i].size(); j++)
+            std::cout << sep << std::setw(widths[j]) << rows[i][j];
+        std::cout << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+void error_table()
+{
+    std::vector<std::size_t> sizes = { 10, 50, 100, 500, 1000, 5000, 10000, 50000, 100000, 500000, 1000000 };
+    std::vector<std::string> methods = { "Thomas algorithm", "Unstable method", "PCR solver", "Partition solver",
+                                         "Mixed precision", "Pivoting LU", "Auto (num::solve)" };
+
+    std::array<real, 8> range;
+    limits(range[0], range[1], range[2], range[3], range[4], range[5], range[6], range[7], "x*");
+
+    std::size_t threads, solver_threads, trials;
+    std::cout << "Enter thread count for table (0 - all cores): ";
+    std::cin >> threads;
+    std::cout << "Enter thread count for parallel solvers (0 - all cores): ";
+    std::cin >> solver_threads;
+    std::cout << "Enter trial count per size: ";
+    std::cin >> trials;
+    std::cout << "Enter output path prefix for .csv and .json (- to skip): ";
+    std::string prefix;
+    std::cin >> prefix;
+    std::cout << std::endl;
+    if (solver_threads == 0)
+        solver_threads = std::thread::hardware_concurrency();
+    //every trial may run a parallel solver, more of them at once would time oversubscription
+    std::size_t max_threads = std::max<std::size_t>(1, std::thread::hardware_concurrency() / solver_threads);
+    if (threads == 0 || threads > max_threads)
+    {
+        if (threads > max_threads)
+            std::cout << "Table thread count capped at " << max_threads << " for " << solver_threads
+                      << " solver threads." << std::endl << std::endl;
+        threads = max_threads;
+    }
+    trials = std::max<std::size_t>(trials, 1);
+
+    //one task per (size, trial), seeded by its position so that results do not depend on scheduling
+    struct trial_result
+    {
+        real gen_time, condition;
+        std::vector<real> error, residual, residual_2, time;
+    };
+    std::vector<std::future<trial_result>> futures;
+    num::stats::reset();
+    {
+        num::thread_pool pool(threads);
+        for (std::size_t i = 0; i < sizes.size(); i++)
+            for (std::size_t t = 0; t < trials; t++)
+                futures.push_back(pool.submit([&, i, t]()
+                {
+                    trial_result res;
+                    num::tridiag<real> mat;
+                    num::vector<real> exact;
+                    timed(res.gen_time, [&]()
+                    {
+                        num::random_key key{ i * trials + t };
+                        mat = num::tridiag<real>(sizes[i], range[0], range[1], range[2], range[3], range[4], range[5], key);
+                        exact = num::vector<real>(sizes[i], range[6], range[7], num::random_key{ key.seed, 3 });
+                        return 0;
+                    });
+                    auto vec = mat * exact;
+                    res.condition = num::condition_estimate(mat);
+
+                    std::vector<std::function<num::vector<real>()>> solvers = {
+                        [&]() { return num::thomas_alg(mat, vec); },
+                        [&]() { return num::unstable_method(mat, vec); },
+                        [&]() { return num::pcr_solve(mat, vec, solver_threads); },
+                        [&]() { return num::partition_solve(mat, vec, solver_threads); },
+                        [&]() { return num::solve_mixed(mat, vec); },
+                        [&]() { return num::pivot_solve(mat, vec); },
+                        [&]() { return num::solve(mat, vec); }
+                    };
+                    for (auto &solver : solvers)
+                    {
+                        real time;
+                        auto x = timed(time, solver);
+                        res.error.push_back((exact - x).norm());
+                        auto residual = num::residual(mat, x, vec);
+                        res.residual.push_back(residual.inf);
+                        res.residual_2.push_back(residual.two);
+                        res.time.push_back(time);
+                    }
+                    return res;
+                }));
+    }
+
+    //aggregate in fixed order: maximum error, residual and condition, mean times over trials
+    std::vector<std::vector<real>> errors(sizes.size()), residuals(sizes.size()), residuals_2(sizes.size()),
+                                   conditions(sizes.size()), times(sizes.size());
+    for (std::size_t i = 0; i < sizes.size(); i++)
+    {
+        errors[i].assign(methods.size(), 0);
+        residuals[i].assign(methods.size(), 0);
+        residuals_2[i].assign(methods.size(), 0);
+        conditions[i].assign(2, 0);
+        times[i].assign(methods.size() + 1, 0);
+        for (std::size_t t = 0; t < trials; t++)
+        {
+            auto res = futures[i * trials + t].get();
+            for (std::size_t j = 0; j < methods.size(); j++)
+            {
+                errors[i][j] = num::nan_max(errors[i][j], res.error[j]);
+                residuals[i][j] = num::nan_max(residuals[i][j], res.residual[j]);
+                residuals_2[i][j] = num::nan_max(residuals_2[i][j], res.residual_2[j]);
+                times[i][j] += res.time[j] / trials;
+            }
+            times[i][methods.size()] += res.gen_time / trials;
+            conditions[i][0] = num::nan_max(conditions[i][0], res.condition);
+        }
+        conditions[i][1] = conditions[i][0] * std::numeric_limits<real>::epsilon();
+    }
+
+    std::vector<std::string> heads_error, heads_residual, heads_time;
+    for (auto &method : methods)
+    {
+        heads_error.push_back(method + " ERROR");
+        heads_residual.push_back(method + " RESIDUAL");
+        heads_time.push_back(method + " TIME");
+    }
+    heads_time.push_back("Generation TIME");
+
+    print_table(sizes, heads_error, errors);
+    print_table(sizes, heads_residual, residuals);
+    print_table(sizes, { "CONDITION ESTIMATE", "ERROR BOUND (COND * EPS)" }, conditions);
+    print_table(sizes, heads_time, times);
+
+    if constexpr (num::stats::enabled())
+        std::cout << "Solver statistics over the whole table:" << std::endl << num::stats::snapshot() << std::endl;
+
+    if (prefix == "-")
+        return;
+
+    std::ofstream csv(prefix + ".csv"), json(prefix + ".json");
+    csv << std::setprecision(std::numeric_limits<real>::max_digits10)
+        << "size,method,trials,error_max,residual_max,residual_2_max,condition_max,solve_time_mean,generation_time_mean"
+        << std::endl;
+    json << std::setprecision(std::numeric_limits<real>::max_digits10) << "[" << std::endl;
+    auto json_number = [](std::ostream &out, real val) -> std::ostream &
+    {
+        return std::isfinite(val) ? out << val : out << "null";
+    };
+    for (std::size_t i = 0; i < sizes.size(); i++)
+        for (std::size_t j = 0; j < methods.size(); j++)
+        {
+            csv << sizes[i] << ',' << methods[j] << ',' << trials << ',' << errors[i][j] << ','
+                << residuals[i][j] << ',' << residuals_2[i][j] << ',' << conditions[i][0] << ','
+                << times[i][j] << ',' << times[i][methods.size()] << std::endl;
+
+            json << "  {\"size\": " << sizes[i] << ", \"method\": \"" << methods[j] << "\", \"trials\": " << trials
+                 << ", \"error_max\": ";
+            json_number(json, errors[i][j]) << ", \"residual_max\": ";
+            json_number(json, residuals[i][j]) << ", \"residual_2_max\": ";
+            json_number(json, residuals_2[i][j]) << ", \"condition_max\": ";
+            json_number(json, conditions[i][0]) << ", \"solve_time_mean\": " << times[i][j]
+                 << ", \"generation_time_mean\": " << times[i][methods.size()] << "}"
+                 << (i + 1 < sizes.size() || j + 1 < methods.size() ? "," : "") << std::endl;
+        }
+    json << "]" << std::endl;
+    std::cout << "Table written to " << prefix << ".csv and " << prefix << ".json." << std::endl << std::endl;
+}
+
+void batch_mode()
+{
+    std::size_t n, count;
+    std::cout << "Enter system size: ";
+    std::cin >> n;
+    std::cout << "Enter number of systems: ";
+    std::cin >> count;
+    std::cout << std::endl;
+
+    if (n < 2 || count < 1)
+    {
+        std::cout << "Size less than 2 or no systems. Return to main menu." << std::endl << std::endl;
+        return;
+    }
 
     real min_a, max_a, min_b, max_b, min_c, max_c, min, max;
-    limits(min_a, max_a, min_b, max_b, min_c, max_c, min, max, "x*");
+    limits(min_a, max_a, min_b, max_b, min_c, max_c, min, max, "d");
+
+    std::vector<num::tridiag<real>> mats(count);
+    std::vector<num::vector<real>> vecs(count), thomas(count);
+    num::tridiag_batch<real> batch_mats(n, count);
+    num::multivector<real> batch_vecs(n, count);
+    for (std::size_t k = 0; k < count; k++)
+    {
+        mats[k] = num::tridiag<real>(n, min_a, max_a, min_b, max_b, min_c, max_c);
+        vecs[k] = num::vector<real>(n, min, max);
+        batch_mats.set(k, mats[k]);
+        batch_vecs.column(k, vecs[k]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < count; k++)
+        thomas[k] = num::thomas_alg(mats[k], vecs[k]);
+    auto middle = std::chrono::steady_clock::now();
+    auto batch = num::thomas_batch(batch_mats, batch_vecs);
+    auto end = std::chrono::steady_clock::now();
+
+    real diff = 0;
+    for (std::size_t k = 0; k < count; k++)
+        diff = std::max(diff, (thomas[k] - batch.column(k)).norm());
+
+    std::chrono::duration<real> time_loop = middle - start, time_batch = end - middle;
+    std::cout << std::defaultfloat << std::noshowpos
+              << "Thomas algorithm loop: " << count / time_loop.count() << " systems/s" << std::endl
+              << "Thomas algorithm batch: " << count / time_batch.count() << " systems/s" << std::endl
+              << "Speedup: " << time_loop.count() / time_batch.count() << std::endl
+              << "Result difference norm max ||[x]T - [x]b|| is: " << diff << std::endl << std::endl;
+}
+
+void convert_mode()
+{
+    std::string text_path, binary_path;
+    std::cout << "Enter text file path: ";
+    std::cin.ignore();
+    std::getline(std::cin, text_path);
+    std::cout << "Enter binary file path: ";
+    std::getline(std::cin, binary_path);
+    std::cout << std::endl;
+
+    if (!num::text_to_binary<real>(text_path, binary_path))
+    {
+        std::cout << "Conversion failed. Return to main menu." << std::endl << std::endl;
+        return;
+    }
+
+    num::mapped_system<real> sys;
+    if (!sys.open(binary_path))
+    {
+        std::cout << "Written file can not be mapped. Return to main menu." << std::endl << std::endl;
+        return;
+    }
+
+    //solve straight from the mapping, no copies of the diagonals
+    num::vector<real> x(sys.size());
+    num::workspace<real> ws;
+    num::thomas_alg(sys.matrix_view(), sys.rhs_view(), x, ws);
+
+    std::cout << "File successfully converted, system size is " << sys.size() << "." << std::endl << std::endl
+              << "Result vector [x] from Thomas algorithm on mapped file is:" << std::endl << x << std::endl;
+}
+
+void stream_mode()
+{
+    std::string system_path, solution_path;
+    std::cout << "Enter binary system file path: ";
+    std::cin.ignore();
+    std::getline(std::cin, system_path);
+    std::cout << "Enter solution file path: ";
+    std::getline(std::cin, solution_path);
+    std::size_t chunk;
+    std::cout << "Enter chunk size (rows): ";
+    std::cin >> chunk;
+    std::cout << std::endl;
+
+    if (chunk < 1)
+    {
+        std::cout << "Chunk size less than 1. Return to main menu." << std::endl << std::endl;
+        return;
+    }
+
+    real seconds;
+    bool done = timed(seconds, [&]()
+    {
+        return num::thomas_stream<real>(system_path, solution_path, solution_path + ".scratch", chunk);
+    });
+    std::remove((solution_path + ".scratch").c_str());
+
+    if (!done)
+    {
+        std::cout << "Out-of-core solve failed. Return to main menu." << std::endl << std::endl;
+        return;
+    }
+    std::cout << std::defaultfloat << std::noshowpos
+              << "Solution written as raw array to " << solution_path << " in " << seconds << " s." << std::endl << std::endl;
+}
+
+//command line mode: laba1 [options] input..., every input is a text file of concatenated systems,
+//a binary system file, a directory of such files or - for standard input; or laba1 --serve PATH
+struct cli_options
+{
+    std::vector<std::string> inputs;
+    std::string method = "auto", precision = "double", output = "-", serve;
+    std::size_t threads = 1, solver_threads = 1, queue = 0;     //queue 0: default of the mode
+};
+
+void cli_usage()
+{
+    std::cerr << "usage: laba1 [options] input..." << std::endl
+              << "       laba1 --serve PATH [-t N] [-q N]" << std::endl
+              << "  -i, --input PATH           system file, directory of files or - for stdin (repeatable)" << std::endl
+              << "  -m, --method NAME          auto, thomas, pivot, unstable, pcr, partition or mixed (default auto:" << std::endl
+              << "                             thomas for diagonally dominant systems, pivot otherwise)" << std::endl
+              << "  -p, --precision NAME       double or float (default double)" << std::endl
+              << "  -t, --threads N            solving stage threads (default 1)" << std::endl
+              << "  -s, --solver-threads N     threads inside pcr and partition solvers (default 1)" << std::endl
+              << "  -q, --queue N              systems buffered between stages (default 16, server 1024)" << std::endl
+              << "  -o, --output PATH          solutions file or - for stdout (default -)" << std::endl
+              << "  -S, --serve PATH           solve requests on unix socket PATH until a client shuts it down" << std::endl;
+}
+
+bool cli_parse(int argc, char **argv, cli_options &opt)
+{
+    auto count = [](const std::string &text, std::size_t &value)
+    {
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return ec == std::errc() && ptr == text.data() + text.size() && value > 0;
+    };
+
+    for (int k = 1; k < argc; k++)
+    {
+        std::string arg = argv[k];
+        if (arg == "-h" || arg == "--help")
+            return false;
+        if (arg[0] != '-' || arg == "-")
+        {
+            opt.inputs.push_back(arg);
+            continue;
+        }
+        if (k + 1 == argc)
+        {
+            std::cerr << "Option " << arg << " needs a value." << std::endl;
+            return false;
+        }
+        std::string value = argv[++k];
+        bool valid = true;
+        if (arg == "-i" || arg == "--input")
+            opt.inputs.push_back(value);
+        else if (arg == "-m" || arg == "--method")
+            valid = (opt.method = value) == "auto" || value == "thomas" || value == "pivot" || value == "unstable" ||
+                    value == "pcr" || value == "partition" || value == "mixed";
+        else if (arg == "-p" || arg == "--precision")
+            valid = (opt.precision = value) == "double" || value == "float";
+        else if (arg == "-t" || arg == "--threads")
+            valid = count(value, opt.threads);
+        else if (arg == "-s" || arg == "--solver-threads")
+            valid = count(value, opt.solver_threads);
+        else if (arg == "-q" || arg == "--queue")
+            valid = count(value, opt.queue);
+        else if (arg == "-o" || arg == "--output")
+            opt.output = value;
+        else if (arg == "-S" || arg == "--serve")
+            opt.serve = value;
+        else
+        {
+            std::cerr << "Unknown option " << arg << "." << std::endl;
+            return false;
+        }
+        if (!valid)
+        {
+            std::cerr << "Invalid value " << value << " of option " << arg << "." << std::endl;
+            return false;
+        }
+    }
+    if (opt.inputs.empty() && opt.serve.empty())
+    {
+        std::cerr << "No input given." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//read -> solve -> write pipeline: one reader thread parses systems in input order, opt.threads threads solve them,
+//one writer thread restores the order and prints them; bounded queues between stages keep memory flat
+//and let the slowest stage set the pace
+template<std::floating_point T>
+int cli_run(const cli_options &opt)
+{
+    struct job
+    {
+        std::size_t index;
+        num::tridiag<T> mat;
+        num::vector<T> vec;
+    };
+    std::size_t capacity = opt.queue ? opt.queue : 16;
+    num::bounded_queue<job> parsed(capacity), solved(capacity);
+    std::atomic<bool> failed = false;
+
+    //reorder window: a solver waits while its job is capacity or more ahead of the writer,
+    //so at most capacity solved systems wait for an earlier one that is still being solved
+    std::mutex window_mutex;
+    std::condition_variable window_moved;
+    std::size_t written = 0;
+
+    std::ofstream file;
+    if (opt.output != "-")
+    {
+        file.open(opt.output, std::ios::binary);
+        if (!file.is_open())
+        {
+            std::cerr << "Can not open " << opt.output << " for writing." << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &out = opt.output == "-" ? std::cout : file;
+
+    real seconds;
+    timed(seconds, [&]()
+    {
+        std::jthread reader([&]()
+        {
+            std::size_t index = 0;
+            auto parse = [&](const std::string &name, const std::string &buffer)
+            {
+                const char *first = buffer.data(), *last = first + buffer.size();
+                for (std::size_t k = 1; ; k++)
+                {
+                    while (first != last && num::is_space(*first))
+                        first++;
+                    if (first == last)
+                        return;
+                    job item{ index, {}, {} };
+                    if (!num::parse_next(first, last, item.mat, item.vec, opt.solver_threads))
+                    {
+                        std::cerr << name << ": system " << k << " is not valid, rest of input skipped." << std::endl;
+                        failed = true;
+                        return;
+                    }
+                    index++;
+                    parsed.push(std::move(item));
+                }
+            };
+            auto read = [&](const std::string &path)
+            {
+                if (num::is_binary(path))
+                {
+                    num::mapped_system<T> sys;
+                    if (!sys.open(path))
+                    {
+                        std::cerr << path << ": binary file is invalid or of other precision." << std::endl;
+                        failed = true;
+                        return;
+                    }
+                    parsed.push(job{ index++, sys.matrix(), sys.rhs() });
+                    return;
+                }
+                std::string buffer;
+                if (!num::read_file(path, buffer))
+                {
+                    std::cerr << path << ": can not be read." << std::endl;
+                    failed = true;
+                    return;
+                }
+                parse(path, buffer);
+            };
+
+            for (auto &input : opt.inputs)
+            {
+                if (input == "-")
+                    parse("stdin", std::string(std::istreambuf_iterator<char>(std::cin), {}));
+                else if (std::filesystem::is_directory(input))
+                {
+                    std::vector<std::filesystem::path> paths;
+                    for (auto &entry : std::filesystem::directory_iterator(input))
+                        if (entry.is_regular_file())
+                            paths.push_back(entry.path());
+                    std::ranges::sort(paths);
+                    for (auto &path : paths)
+                        read(path.string());
+                }
+                else
+                    read(input);
+            }
+            parsed.close();
+        });
 
-    std::cout << std::setw(width_size) << "SIZE" << sep
-              << std::setw(width_thomas) << head_thomas << sep
-              << std::setw(width_unstable) << head_unstable << std::endl
+        std::atomic<std::size_t> running = opt.threads;
+        std::vector<std::jthread> solvers;
+        for (std::size_t t = 0; t < opt.threads; t++)
+            solvers.emplace_back([&]()
+            {
+                num::workspace<T> ws;
+                while (auto item = parsed.pop())
+                {
+                    {
+                        std::unique_lock lock(window_mutex);
+                        window_moved.wait(lock, [&]() { return item->index < written + capacity; });
+                    }
 
-              << std::setfill('_') << ' '
-              << std::setw(width_size + 1) << "|"
-              << std::setw(width_thomas + 3) << "|"
-              << std::setw(width_unstable + 1) << "_" << std::endl
+                    bool regular = true;
+                    if (opt.method == "auto")
+                        regular = num::solve(item->mat, item->vec, ws);
+                    else if (opt.method == "pivot")
+                        regular = num::pivot_solve(item->mat, item->vec, ws);
+                    else if (opt.method == "thomas")
+                        num::thomas_alg(item->mat, item->vec, ws);
+                    else if (opt.method == "unstable")
+                        num::unstable_method(item->mat, item->vec, ws);
+                    else if (opt.method == "pcr")
+                        item->vec = num::pcr_solve(item->mat, item->vec, opt.solver_threads);
+                    else if (opt.method == "partition")
+                        item->vec = num::partition_solve(item->mat, item->vec, opt.solver_threads);
+                    else
+                        item->vec = num::solve_mixed(item->mat, item->vec);
+                    if (!regular)
+                    {
+                        std::cerr << "System " << item->index + 1 << " is singular." << std::endl;
+                        item->vec = num::vector<T>(item->vec.size(), std::numeric_limits<T>::quiet_NaN());
+                        failed = true;
+                    }
+                    solved.push(std::move(*item));
+                }
+                if (--running == 0)
+                    solved.close();
+            });
 
-              << std::setfill(' ')
-              << std::setw(width_size + 3) << sep
-              << std::setw(width_thomas + 3) << sep
-              << std::endl;
+        std::jthread writer([&]()
+        {
+            std::map<std::size_t, job> pending;
+            num::text_writer text(out);
+            while (auto item = solved.pop())
+            {
+                pending.emplace(item->index, std::move(*item));
+                std::size_t next = written;
+                for (auto it = pending.begin(); it != pending.end() && it->first == next; it = pending.erase(it))
+                {
+                    num::write_text(text, it->second.mat, it->second.vec);
+                    next++;
+                }
+                if (next != written)
+                {
+                    {
+                        std::lock_guard lock(window_mutex);
+                        written = next;
+                    }
+                    window_moved.notify_all();
+                }
+            }
+            text.flush();
+            out.flush();
+        });
+        return 0;
+    });
 
-    for (auto size : sizes)
+    if (!out)
     {
-        num::tridiag<real> mat(size, min_a, max_a, min_b, max_b, min_c, max_c);
-        num::vector<real> exact(size, min, max);
+        std::cerr << "Writing solutions failed." << std::endl;
+        return 1;
+    }
+    std::cerr << std::defaultfloat << "Solved " << written << " systems in " << seconds << " s." << std::endl;
+    return failed ? 1 : 0;
+}
 
-        auto vec = mat * exact;
-        auto thomas = num::thomas_alg(mat, vec);
-        auto unstable = num::unstable_method(mat, vec);
+//daemon mode: requests of any precision over the socket, see laba1_client
+int serve(const cli_options &opt)
+{
+    num::net::server_options options;
+    options.threads = opt.threads;
+    if (opt.queue)
+        options.queue = opt.queue;
 
-        std::cout << std::setw(width_size) << mat.size() << sep
-                  << std::setw(width_thomas) << (exact - thomas).norm() << sep
-                  << std::setw(width_unstable) << (exact - unstable).norm()
-                  << std::endl;
+    num::net::solve_server server(opt.serve, options);
+    if (!server.listen())
+    {
+        std::cerr << "Can not listen on " << opt.serve << "." << std::endl;
+        return 1;
     }
+    std::cerr << "Listening on " << opt.serve << " with " << options.threads << " workers." << std::endl;
+    server.run();
+    std::cerr << "Server stopped." << std::endl << server.stats();
+    return 0;
+}
 
+int cli_main(int argc, char **argv)
+{
+    cli_options opt;
+    if (!cli_parse(argc, argv, opt))
+    {
+        cli_usage();
+        return 2;
+    }
+    if (!opt.serve.empty())
+        return serve(opt);
+    return opt.precision == "float" ? cli_run<float>(opt) : cli_run<real>(opt);
+}
+
+//print mode of std::cout for every later matrix and vector, see num::print_mode
+void print_mode()
+{
+    std::cout << "Select print mode:" << std::endl
+              << "\t0 - automatic (dense for small systems, summary of diagonals and plain vectors for large);" << std::endl
+              << "\t1 - dense;" << std::endl
+              << "\t2 - diagonals;" << std::endl
+              << "\t3 - summary;" << std::endl
+              << "\t4 - plain." << std::endl;
+    int mode;
+    std::cin >> mode;
+    std::size_t edge = 3;
+    if (mode == 3)
+    {
+        std::cout << "Enter values shown at each end: ";
+        std::cin >> edge;
+    }
     std::cout << std::endl;
+
+    if (mode < 0 || mode > 4)
+    {
+        std::cout << "Unknown print mode. Return to main menu." << std::endl << std::endl;
+        return;
+    }
+    std::cout << num::print_as{ num::print_mode(mode), edge };
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    if (argc > 1)
+        return cli_main(argc, argv);
+
     int choice;
     while (true)
     {
@@ -211,6 +1023,12 @@ int main()
                   << "\t1 - solution mode;" << std::endl
                   << "\t2 - test mode;" << std::endl
                   << "\t3 - error table;" << std::endl
+                  << "\t4 - batch mode;" << std::endl
+                  << "\t5 - convert text file to binary;" << std::endl
+                  << "\t6 - out-of-core solve of binary file;" << std::endl
+                  << "\t7 - cyclic system test mode;" << std::endl
+                  << "\t8 - block system test mode;" << std::endl
+                  << "\t9 - print mode;" << std::endl
                   << "\tother - exit." << std::endl;
 
         std::cin >> choice;
@@ -227,6 +1045,24 @@ int main()
             case 3:
                 error_table();
                 break;
+            case 4:
+                batch_mode();
+                break;
+            case 5:
+                convert_mode();
+                break;
+            case 6:
+                stream_mode();
+                break;
+            case 7:
+                cyclic_mode();
+                break;
+            case 8:
+                block_mode();
+                break;
+            case 9:
+                print_mode();
+                break;
             default:
                 return 0;
         }
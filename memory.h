@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory_resource>
+#include <vector>
+#include <algorithm>
+
+#include "stats.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#define NUM_HAS_HUGE_PAGES 1
+#endif
+
+//class / func decl (forward)
+namespace num
+{
+    class aligned_resource;
+    class huge_page_resource;
+    class arena_resource;
+
+    std::pmr::memory_resource *default_resource();
+}
+
+//class def
+namespace num
+{
+    //raises alignment of every allocation from upstream to at least alignment bytes
+    class aligned_resource : public std::pmr::memory_resource
+    {
+        std::size_t _alignment;
+        std::pmr::memory_resource *_upstream;
+
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    public:
+        explicit aligned_resource(std::size_t alignment = 64,
+                                  std::pmr::memory_resource *upstream = std::pmr::new_delete_resource());
+    };
+
+    //large allocations are mapped on their own: MAP_HUGETLB pages when the system has them reserved,
+    //otherwise 2 MiB aligned anonymous memory advised for transparent huge pages;
+    //allocations below threshold, or on systems without mmap, go to upstream
+    class huge_page_resource : public std::pmr::memory_resource
+    {
+        std::size_t _threshold;
+        std::pmr::memory_resource *_upstream;
+
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    public:
+        static constexpr std::size_t page = std::size_t(1) << 21;
+
+        explicit huge_page_resource(std::size_t threshold = page,
+                                    std::pmr::memory_resource *upstream = default_resource());
+    };
+
+    //bump allocator for solver scratch: allocations are carved from one block, deallocation is free
+    //and reset() makes the whole block available again; requests that do not fit go to upstream
+    class arena_resource : public std::pmr::memory_resource
+    {
+        std::pmr::memory_resource *_upstream;
+        std::byte *_block;
+        std::size_t _capacity, _used = 0;
+
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    public:
+        static constexpr std::size_t block_alignment = 64;
+
+        explicit arena_resource(std::size_t capacity, std::pmr::memory_resource *upstream = default_resource());
+        arena_resource(const arena_resource &other) = delete;
+        arena_resource &operator=(const arena_resource &other) = delete;
+        ~arena_resource() override;
+
+        void reset();
+
+        std::size_t capacity() const;
+        std::size_t used() const;
+    };
+}
+
+//func def
+namespace num
+{
+    inline aligned_resource::aligned_resource(std::size_t alignment, std::pmr::memory_resource *upstream)
+        : _alignment(alignment), _upstream(upstream) {}
+
+    inline void *aligned_resource::do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        NUM_STATS_ALLOCATED(bytes);
+        return _upstream->allocate(bytes, std::max(alignment, _alignment));
+    }
+
+    inline void aligned_resource::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment)
+    {
+        _upstream->deallocate(ptr, bytes, std::max(alignment, _alignment));
+    }
+
+    inline bool aligned_resource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+    {
+        auto *res = dynamic_cast<const aligned_resource *>(&other);
+        return res && res->_alignment == _alignment && res->_upstream->is_equal(*_upstream);
+    }
+
+    //storage of num::vector unless given otherwise: 64 bytes, a full cache line and AVX-512 register
+    inline std::pmr::memory_resource *default_resource()
+    {
+        static aligned_resource res(64);
+        return &res;
+    }
+
+    inline huge_page_resource::huge_page_resource(std::size_t threshold, std::pmr::memory_resource *upstream)
+        : _threshold(threshold), _upstream(upstream) {}
+
+    inline void *huge_page_resource::do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+#ifdef NUM_HAS_HUGE_PAGES
+        if (bytes >= _threshold && alignment <= page)
+        {
+            NUM_STATS_ALLOCATED(bytes);
+            std::size_t size = (bytes + page - 1) / page * page;
+            void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (ptr != MAP_FAILED)
+                return ptr;
+
+            //over-map by a page and trim both ends, so that the range is huge page aligned
+            ptr = mmap(nullptr, size + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED)
+                throw std::bad_alloc();
+            auto *first = static_cast<std::byte *>(ptr);
+            auto *aligned = first + (page - reinterpret_cast<std::uintptr_t>(first) % page) % page;
+            if (aligned != first)
+                munmap(first, aligned - first);
+            if (aligned + size != first + size + page)
+                munmap(aligned + size, first + size + page - (aligned + size));
+            madvise(aligned, size, MADV_HUGEPAGE);
+            return aligned;
+        }
+#endif
+        return _upstream->allocate(bytes, alignment);
+    }
+
+    inline void huge_page_resource::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment)
+    {
+#ifdef NUM_HAS_HUGE_PAGES
+        if (bytes >= _threshold && alignment <= page)
+        {
+            munmap(ptr, (bytes + page - 1) / page * page);
+            return;
+        }
+#endif
+        _upstream->deallocate(ptr, bytes, alignment);
+    }
+
+    inline bool huge_page_resource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+    {
+        return this == &other;
+    }
+
+    inline arena_resource::arena_resource(std::size_t capacity, std::pmr::memory_resource *upstream)
+        : _upstream(upstream),
+          _block(static_cast<std::byte *>(upstream->allocate(capacity, block_alignment))),
+          _capacity(capacity) {}
+
+    inline arena_resource::~arena_resource()
+    {
+        _upstream->deallocate(_block, _capacity, block_alignment);
+    }
+
+    inline void *arena_resource::do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        std::size_t first = (_used + alignment - 1) / alignment * alignment;
+        if (alignment > block_alignment || first + bytes > _capacity)
+            return _upstream->allocate(bytes, alignment);
+        NUM_STATS_ALLOCATED(bytes);
+        _used = first + bytes;
+        return _block + first;
+    }
+
+    inline void arena_resource::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment)
+    {
+        auto *pos = static_cast<std::byte *>(ptr);
+        if (pos < _block || pos >= _block + _capacity)
+            _upstream->deallocate(ptr, bytes, alignment);
+    }
+
+    inline bool arena_resource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+    {
+        return this == &other;
+    }
+
+    //everything allocated from the block must be dead by now
+    inline void arena_resource::reset()
+    {
+        _used = 0;
+    }
+
+    inline std::size_t arena_resource::capacity() const
+    {
+        return _capacity;
+    }
+
+    inline std::size_t arena_resource::used() const
+    {
+        return _used;
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <limits>
+
+#include "solve.h"
+#include "factorization.h"
+#include "view.h"
+
+//class / func decl (forward)
+namespace num
+{
+    struct refinement;
+
+    template<std::floating_point T, std::floating_point L = float>
+    vector<T> solve_mixed(const tridiag<T> &mat, const vector<T> &vec);
+    template<std::floating_point T, std::floating_point L = float>
+    refinement solve_mixed(const tridiag<T> &mat, const vector<T> &vec, vector<T> &x,
+                           const T &tol = 8 * std::numeric_limits<T>::epsilon(), std::size_t max_iterations = 20);
+    template<std::floating_point T, std::floating_point L = float>
+    vector<T> solve_mixed(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec);
+    template<std::floating_point T, std::floating_point L = float>
+    refinement solve_mixed(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec, vector<T> &x,
+                           const T &tol = 8 * std::numeric_limits<T>::epsilon(), std::size_t max_iterations = 20);
+}
+
+//class def
+namespace num
+{
+    //outcome of iterative refinement: number of low precision sweeps and whether it gave up on them
+    struct refinement
+    {
+        std::size_t iterations = 0;
+        bool fallback = false;
+    };
+}
+
+//func def
+namespace num
+{
+    template<std::floating_point T, std::floating_point L>
+    vector<T> solve_mixed(const tridiag<T> &mat, const vector<T> &vec)
+    {
+        return solve_mixed<T, L>(tridiag_view<T>(mat), vector_view<const T>(vec));
+    }
+
+    template<std::floating_point T, std::floating_point L>
+    refinement solve_mixed(const tridiag<T> &mat, const vector<T> &vec, vector<T> &x,
+                           const T &tol, std::size_t max_iterations)
+    {
+        return solve_mixed<T, L>(tridiag_view<T>(mat), vector_view<const T>(vec), x, tol, max_iterations);
+    }
+
+    template<std::floating_point T, std::floating_point L>
+    vector<T> solve_mixed(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec)
+    {
+        vector<T> x(mat.size());
+        solve_mixed<T, L>(mat, vec, x);
+        return x;
+    }
+
+    //factorization and sweeps are done in L, residual d - A * x in T;
+    //refinement stops once ||d - A * x|| <= tol * (||A|| * ||x|| + ||d||) and falls back
+    //to thomas_alg in T when the residual stops halving
+    template<std::floating_point T, std::floating_point L>
+    refinement solve_mixed(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec, vector<T> &x,
+                           const T &tol, std::size_t max_iterations)
+    {
+        std::size_t n = mat.size();
+        refinement res;
+
+        tridiag<L> low(n);
+        for (std::size_t i = 1; i <= n; i++)
+        {
+            low.b[i] = L(mat.b[i]);
+            if (i > 1)
+                low.a[i] = L(mat.a[i]);
+            if (i < n)
+                low.c[i] = L(mat.c[i]);
+        }
+        thomas_factorization<L> factor(low);
+
+        T mat_norm = 0;
+        for (std::size_t i = 1; i <= n; i++)
+            mat_norm = std::max(mat_norm, std::abs(i > 1 ? mat.a[i] : 0) + std::abs(mat.b[i])
+                                          + std::abs(i < n ? mat.c[i] : 0));
+        T vec_norm = vec.norm();
+
+        x = vector<T>(n);
+        vector<T> r(vec);
+        vector<L> step(n);
+        T r_norm = vec_norm;
+        while (res.iterations < max_iterations && r_norm != 0)
+        {
+            //residual is scaled to unit norm so that L does not underflow on late steps
+            for (std::size_t i = 0; i < n; i++)
+                step.data()[i] = L(r.data()[i] / r_norm);
+            factor.solve(step);
+            for (std::size_t i = 0; i < n; i++)
+                x.data()[i] += r_norm * T(step.data()[i]);
+            res.iterations++;
+
+            r = vec - mat * x;
+            T prev = r_norm;
+            r_norm = r.norm();
+            if (r_norm <= tol * (mat_norm * x.norm() + vec_norm))
+                return res;
+            if (!(r_norm <= prev / 2))
+                break;
+        }
+        if (r_norm == 0)
+            return res;
+
+        workspace<T> ws;
+        thomas_alg(mat, vec, x, ws);
+        res.fallback = true;
+        return res;
+    }
+}
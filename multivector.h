@@ -0,0 +1,120 @@
+#pragma once
+
+#include "vector.h"
+
+//class / func decl (forward)
+namespace num
+{
+    template<std::floating_point T>
+    class multivector;
+
+    template<std::floating_point T>
+    bool operator==(const multivector<T> &lhs, const multivector<T> &rhs);
+    template<std::floating_point T>
+    bool operator!=(const multivector<T> &lhs, const multivector<T> &rhs);
+
+    template<std::floating_point T>
+    std::ostream &operator<<(std::ostream &out, const multivector<T> &vecs);
+}
+
+//class def
+namespace num
+{
+    //count vectors of equal size stored interleaved:
+    //row [pos] holds component pos of every vector contiguously
+    template<std::floating_point T>
+    class multivector
+    {
+        std::vector<T> _values;
+        std::size_t _count;
+
+    public:
+        int indexing = 1;
+
+        multivector(std::size_t size = 1, std::size_t count = 1, const T &value = 0, int indexing = 1);
+
+        T *operator[](std::size_t pos);
+        const T *operator[](std::size_t pos) const;
+
+        std::size_t size() const;
+        std::size_t count() const;
+
+        vector<T> column(std::size_t k) const;
+        void column(std::size_t k, const vector<T> &vec);
+
+        friend bool operator==<T>(const multivector &lhs, const multivector &rhs);
+        friend bool operator!=<T>(const multivector &lhs, const multivector &rhs);
+
+        friend std::ostream &operator<<<T>(std::ostream &out, const multivector &vecs);
+    };
+}
+
+//func def
+namespace num
+{
+    template<std::floating_point T>
+    multivector<T>::multivector(std::size_t size, std::size_t count, const T &value, int indexing)
+        : _values(size * count, value), _count(count), indexing(indexing) {}
+
+    template<std::floating_point T>
+    T *multivector<T>::operator[](std::size_t pos)
+    {
+        return _values.data() + (pos - indexing) * _count;
+    }
+
+    template<std::floating_point T>
+    const T *multivector<T>::operator[](std::size_t pos) const
+    {
+        return _values.data() + (pos - indexing) * _count;
+    }
+
+    template<std::floating_point T>
+    std::size_t multivector<T>::size() const
+    {
+        return _count ? _values.size() / _count : 0;
+    }
+
+    template<std::floating_point T>
+    std::size_t multivector<T>::count() const
+    {
+        return _count;
+    }
+
+    template<std::floating_point T>
+    vector<T> multivector<T>::column(std::size_t k) const
+    {
+        std::size_t n = size();
+        vector<T> res(n, 0, indexing);
+        for (std::size_t i = indexing; i < n + indexing; i++)
+            res[i] = (*this)[i][k];
+        return res;
+    }
+
+    template<std::floating_point T>
+    void multivector<T>::column(std::size_t k, const vector<T> &vec)
+    {
+        std::size_t n = size();
+        for (std::size_t i = 0; i < n; i++)
+            (*this)[i + indexing][k] = vec[i + vec.indexing];
+    }
+
+    template<std::floating_point T>
+    bool operator==(const multivector<T> &lhs, const multivector<T> &rhs)
+    {
+        return lhs._count == rhs._count && std::ranges::equal(lhs._values, rhs._values);
+    }
+
+    template<std::floating_point T>
+    bool operator!=(const multivector<T> &lhs, const multivector<T> &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<std::floating_point T>
+    std::ostream &operator<<(std::ostream &out, const multivector<T> &vecs)
+    {
+        for (std::size_t k = 0; k < vecs.count(); k++)
+            out << vecs.column(k);
+        return out;
+    }
+}
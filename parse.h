@@ -0,0 +1,220 @@
+#pragma once
+
+#include <charconv>
+#include <span>
+#include <thread>
+#include <string>
+#include <fstream>
+
+#include "tridiag.h"
+
+//func decl
+namespace num
+{
+    template<std::floating_point T>
+    bool parse_text(const std::string &path, tridiag<T> &mat, vector<T> &vec,
+                    std::size_t threads = std::thread::hardware_concurrency());
+
+    template<std::floating_point T>
+    bool parse_text(const char *first, const char *last, tridiag<T> &mat, vector<T> &vec,
+                    std::size_t threads = std::thread::hardware_concurrency());
+
+    template<std::floating_point T>
+    bool parse_next(const char *&first, const char *last, tridiag<T> &mat, vector<T> &vec,
+                    std::size_t threads = 1);
+    template<std::floating_point T>
+    std::ostream &write_text(std::ostream &out, const tridiag<T> &mat, const vector<T> &vec);
+    template<std::floating_point T>
+    text_writer &write_text(text_writer &writer, const tridiag<T> &mat, const vector<T> &vec);
+
+    bool read_file(const std::string &path, std::string &buffer);
+    bool parse_size(const char *&first, const char *last, std::size_t &size);
+    template<std::floating_point T>
+    bool parse_arrays(const char *first, const char *last, std::span<T *const> targets,
+                      std::span<const std::size_t> sizes, std::size_t threads);
+}
+
+//func def
+namespace num
+{
+    inline bool is_space(char ch)
+    {
+        return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r' || ch == '\v' || ch == '\f';
+    }
+
+    //text format read by operator>>: n, then a (n - 1), b (n), c (n - 1), d (n) separated by any whitespace;
+    //whole file is read at once and parsed with from_chars
+    template<std::floating_point T>
+    bool parse_text(const std::string &path, tridiag<T> &mat, vector<T> &vec, std::size_t threads)
+    {
+        std::string buffer;
+        return read_file(path, buffer) && parse_text(buffer.data(), buffer.data() + buffer.size(), mat, vec, threads);
+    }
+
+    template<std::floating_point T>
+    bool parse_text(const char *first, const char *last, tridiag<T> &mat, vector<T> &vec, std::size_t threads)
+    {
+        std::size_t n;
+        if (!parse_size(first, last, n))
+            return false;
+
+        mat = tridiag<T>(n);
+        vec = vector<T>(n);
+        T *targets[] = { mat.a.data(), mat.b.data(), mat.c.data(), vec.data() };
+        std::size_t sizes[] = { n - 1, n, n - 1, n };
+        return parse_arrays<T>(first, last, targets, sizes, threads);
+    }
+
+    //next system of a concatenated stream of parse_text systems, first is moved past it;
+    //its extent is found by a serial token scan, then the values are parsed by parse_arrays
+    template<std::floating_point T>
+    bool parse_next(const char *&first, const char *last, tridiag<T> &mat, vector<T> &vec, std::size_t threads)
+    {
+        const char *pos = first;
+        std::size_t n;
+        if (!parse_size(pos, last, n) || n > std::size_t(last - pos))
+            return false;
+
+        const char *begin = pos;
+        for (std::size_t tokens = 0; tokens < 4 * n - 2; tokens++)
+        {
+            while (pos != last && is_space(*pos))
+                pos++;
+            if (pos == last)
+                return false;
+            while (pos != last && !is_space(*pos))
+                pos++;
+        }
+
+        mat = tridiag<T>(n);
+        vec = vector<T>(n);
+        T *targets[] = { mat.a.data(), mat.b.data(), mat.c.data(), vec.data() };
+        std::size_t sizes[] = { n - 1, n, n - 1, n };
+        if (!parse_arrays<T>(begin, pos, targets, sizes, threads))
+            return false;
+        first = pos;
+        return true;
+    }
+
+    //same layout as parse_text: n, then a, b, c and vec one per line
+    template<std::floating_point T>
+    std::ostream &write_text(std::ostream &out, const tridiag<T> &mat, const vector<T> &vec)
+    {
+        text_writer writer(out, std::min<std::size_t>(1 << 20, (4 * mat.size() + 1) * text_writer::max_value));
+        write_text(writer, mat, vec);
+        return out;
+    }
+
+    template<std::floating_point T>
+    text_writer &write_text(text_writer &writer, const tridiag<T> &mat, const vector<T> &vec)
+    {
+        writer.write(mat.size()).write('\n');
+        for (const vector<T> *values : { &mat.a, &mat.b, &mat.c, &vec })
+            writer.write(values->data(), values->size()).write('\n');
+        return writer;
+    }
+
+    inline bool read_file(const std::string &path, std::string &buffer)
+    {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.is_open())
+            return false;
+        buffer.assign(in.tellg(), '\0');
+        in.seekg(0);
+        return bool(in.read(buffer.data(), buffer.size()));
+    }
+
+    //leading system size, first is moved past it
+    inline bool parse_size(const char *&first, const char *last, std::size_t &size)
+    {
+        while (first != last && is_space(*first))
+            first++;
+        auto [ptr, ec] = std::from_chars(first, last, size);
+        if (ec != std::errc() || size < 1)
+            return false;
+        first = ptr;
+        return true;
+    }
+
+    //buffer is split into chunks at whitespace, tokens are counted and then parsed in parallel,
+    //each token going to its place in one of targets, filled one after another with sizes[k] values
+    template<std::floating_point T>
+    bool parse_arrays(const char *first, const char *last, std::span<T *const> targets,
+                      std::span<const std::size_t> sizes, std::size_t threads)
+    {
+        std::vector<std::size_t> starts(sizes.size() + 1, 0);
+        for (std::size_t k = 0; k < sizes.size(); k++)
+            starts[k + 1] = starts[k] + sizes[k];
+        std::size_t total = starts.back();
+
+        //chunk boundaries, moved forward to whitespace so that no token is split
+        threads = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(1, (last - first) / (1 << 16)));
+        std::vector<const char *> bounds(threads + 1);
+        bounds[0] = first;
+        bounds[threads] = last;
+        for (std::size_t t = 1; t < threads; t++)
+        {
+            const char *pos = std::max(bounds[t - 1], first + (last - first) * t / threads);
+            while (pos != last && !is_space(*pos))
+                pos++;
+            bounds[t] = pos;
+        }
+
+        //count tokens of every chunk
+        std::vector<std::size_t> counts(threads + 1, 0);
+        auto count = [&](std::size_t t)
+        {
+            bool in_token = false;
+            for (const char *pos = bounds[t]; pos != bounds[t + 1]; pos++)
+            {
+                bool space = is_space(*pos);
+                counts[t + 1] += !space && !in_token;
+                in_token = !space;
+            }
+        };
+
+        //parse tokens of every chunk starting from its global token index
+        std::vector<char> failed(threads, 0);
+        auto parse = [&](std::size_t t)
+        {
+            const char *pos = bounds[t], *end = bounds[t + 1];
+            std::size_t index = counts[t], part = 0;
+            while (index < total)
+            {
+                while (pos != end && is_space(*pos))
+                    pos++;
+                if (pos == end)
+                    break;
+                if (*pos == '+' && pos + 1 != end && !is_space(pos[1]))
+                    pos++;
+                while (index >= starts[part + 1])
+                    part++;
+                auto [next, err] = std::from_chars(pos, end, targets[part][index - starts[part]]);
+                if (err != std::errc() || (next != end && !is_space(*next)))
+                {
+                    failed[t] = 1;
+                    return;
+                }
+                pos = next;
+                index++;
+            }
+        };
+
+        auto run = [threads](auto &&func)
+        {
+            std::vector<std::jthread> pool;
+            for (std::size_t t = 1; t < threads; t++)
+                pool.emplace_back(func, t);
+            func(0);
+        };
+
+        run(count);
+        for (std::size_t t = 0; t < threads; t++)
+            counts[t + 1] += counts[t];
+        if (counts[threads] < total)
+            return false;
+        run(parse);
+
+        return std::ranges::none_of(failed, [](char f) { return f != 0; });
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <thread>
+#include <barrier>
+
+#include "tridiag.h"
+#include "solve.h"
+#include "view.h"
+
+//func decl
+namespace num
+{
+    template <std::floating_point T>
+    vector<T> partition_solve(const tridiag<T> &mat, const vector<T> &vec,
+                              std::size_t threads = std::thread::hardware_concurrency());
+    template <std::floating_point T>
+    vector<T> partition_solve(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec,
+                              std::size_t threads = std::thread::hardware_concurrency());
+}
+
+//func def
+namespace num
+{
+    //domain decomposition (SPIKE-style): every block's interior is solved by Thomas algorithm
+    //in terms of the block's first and last unknowns, which form a reduced tridiagonal system of size 2 * blocks
+    template <std::floating_point T>
+    vector<T> partition_solve(const tridiag<T> &mat, const vector<T> &vec, std::size_t threads)
+    {
+        return partition_solve(tridiag_view<T>(mat), vector_view<const T>(vec), threads);
+    }
+
+    template <std::floating_point T>
+    vector<T> partition_solve(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec, std::size_t threads)
+    {
+        //variables & result
+        //fewer than two blocks of three rows: nothing to split, and n / 3 < 1 would be an empty clamp range
+        std::size_t n = mat.size();
+        if (n < 6)
+            return thomas_alg(mat, vec);
+        std::size_t blocks = std::clamp<std::size_t>(threads, 1, n / 3);
+        if (blocks < 2)
+            return thomas_alg(mat, vec);
+
+        //0-based accessors a(i), b(i), c(i), d(i)
+        return view_detail::rows(mat, vec, [&](auto a, auto b, auto c, auto d)
+        {
+            //interior solution x[i] = y[i] + v[i] * x[first] + w[i] * x[last]
+            std::vector<T> y(n), v(n), w(n), L(n);
+            tridiag<T> red(2 * blocks);
+            vector<T> red_d(2 * blocks), red_x, x(n);
+
+            std::barrier sync(blocks, [&]() noexcept { red_x = thomas_alg(red, red_d); });
+
+            auto work = [&](std::size_t k)
+            {
+                std::size_t first = n * k / blocks, last = n * (k + 1) / blocks - 1;
+
+                //forward iteration on interior rows, three right-hand sides at once
+                std::size_t i = first + 1;
+                T denom = b(i);
+                L[i] = c(i) / denom;
+                y[i] = d(i) / denom;
+                v[i] = -a(i) / denom;
+                w[i] = i + 1 == last ? -c(i) / denom : 0;
+                for (i++; i < last; i++)
+                {
+                    denom = b(i) - a(i) * L[i - 1];
+                    L[i] = c(i) / denom;
+                    y[i] = (d(i) - a(i) * y[i - 1]) / denom;
+                    v[i] = -a(i) * v[i - 1] / denom;
+                    w[i] = ((i + 1 == last ? -c(i) : 0) - a(i) * w[i - 1]) / denom;
+                }
+
+                //backward iteration
+                for (i = last - 2; i > first; i--)
+                {
+                    y[i] -= L[i] * y[i + 1];
+                    v[i] -= L[i] * v[i + 1];
+                    w[i] -= L[i] * w[i + 1];
+                }
+
+                //rows of first and last unknowns in reduced system (1-based)
+                std::size_t r = 2 * k + 1;
+                if (r > 1)
+                    red.a[r] = a(first);
+                red.b[r] = b(first) + c(first) * v[first + 1];
+                red.c[r] = c(first) * w[first + 1];
+                red_d[r] = d(first) - c(first) * y[first + 1];
+
+                red.a[r + 1] = a(last) * v[last - 1];
+                red.b[r + 1] = b(last) + a(last) * w[last - 1];
+                if (r + 1 < 2 * blocks)
+                    red.c[r + 1] = c(last);
+                red_d[r + 1] = d(last) - a(last) * y[last - 1];
+
+                sync.arrive_and_wait();
+
+                //back substitution of interface unknowns
+                T x_first = red_x[r], x_last = red_x[r + 1];
+                x[first + 1] = x_first;
+                x[last + 1] = x_last;
+                for (i = first + 1; i < last; i++)
+                    x[i + 1] = y[i] + v[i] * x_first + w[i] * x_last;
+            };
+
+            {
+                std::vector<std::jthread> pool;
+                for (std::size_t k = 1; k < blocks; k++)
+                    pool.emplace_back(work, k);
+                work(0);
+            }
+
+            return x;
+        });
+    }
+}
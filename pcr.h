@@ -0,0 +1,115 @@
+#pragma once
+
+#include <thread>
+#include <barrier>
+
+#include "tridiag.h"
+#include "view.h"
+
+//func decl
+namespace num
+{
+    template <std::floating_point T>
+    vector<T> pcr_solve(const tridiag<T> &mat, const vector<T> &vec,
+                        std::size_t threads = std::thread::hardware_concurrency());
+    template <std::floating_point T>
+    vector<T> pcr_solve(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec,
+                        std::size_t threads = std::thread::hardware_concurrency());
+}
+
+//func def
+namespace num
+{
+    //hybrid parallel cyclic reduction: log2(threads) PCR steps split the system
+    //into 2^steps independent interleaved subsystems, which are then solved by Thomas algorithm in parallel
+    template <std::floating_point T>
+    vector<T> pcr_solve(const tridiag<T> &mat, const vector<T> &vec, std::size_t threads)
+    {
+        return pcr_solve(tridiag_view<T>(mat), vector_view<const T>(vec), threads);
+    }
+
+    template <std::floating_point T>
+    vector<T> pcr_solve(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec, std::size_t threads)
+    {
+        //variables & result
+        std::size_t n = mat.size(), steps = 0;
+        if (n == 0)
+            return vector<T>(0);
+        threads = std::clamp<std::size_t>(threads, 1, n);
+        while ((std::size_t(1) << steps) < threads && (std::size_t(2) << steps) <= n)
+            steps++;
+        std::size_t count = std::size_t(1) << steps;
+
+        //0-based working copies, double buffered for reduction steps (a[0] = c[n - 1] = 0)
+        std::vector<T> a(n), b(n), c(n), d(n), a2(n), b2(n), c2(n), d2(n);
+        vector<T> x(n);
+        view_detail::rows(mat, vec, [&](auto row_a, auto row_b, auto row_c, auto row_d)
+        {
+            for (std::size_t i = 0; i < n; i++)
+            {
+                a[i] = row_a(i);
+                b[i] = row_b(i);
+                c[i] = row_c(i);
+                d[i] = row_d(i);
+            }
+        });
+
+        std::size_t stride = 1;
+        std::barrier sync(threads, [&]() noexcept
+        {
+            std::swap(a, a2);
+            std::swap(b, b2);
+            std::swap(c, c2);
+            std::swap(d, d2);
+            stride *= 2;
+        });
+
+        auto work = [&](std::size_t t)
+        {
+            //reduction steps, rows split into contiguous chunks
+            std::size_t first = n * t / threads, last = n * (t + 1) / threads;
+            for (std::size_t step = 0; step < steps; step++)
+            {
+                for (std::size_t i = first; i < last; i++)
+                {
+                    T k1 = i >= stride ? a[i] / b[i - stride] : 0;
+                    T k2 = i + stride < n ? c[i] / b[i + stride] : 0;
+                    a2[i] = i >= stride ? -a[i - stride] * k1 : 0;
+                    c2[i] = i + stride < n ? -c[i + stride] * k2 : 0;
+                    b2[i] = b[i] - (i >= stride ? c[i - stride] * k1 : 0) - (i + stride < n ? a[i + stride] * k2 : 0);
+                    d2[i] = d[i] - (i >= stride ? d[i - stride] * k1 : 0) - (i + stride < n ? d[i + stride] * k2 : 0);
+                }
+                sync.arrive_and_wait();
+            }
+
+            //Thomas algorithm on subsystems j, j + count, j + 2 * count, ...
+            for (std::size_t j = t; j < count; j += threads)
+            {
+                //forward iteration, c and d are overwritten by L and M
+                std::size_t prev = j;
+                c[j] /= b[j];
+                d[j] /= b[j];
+                for (std::size_t i = j + count; i < n; prev = i, i += count)
+                {
+                    T denom = b[i] - a[i] * c[prev];
+                    c[i] /= denom;
+                    d[i] = (d[i] - a[i] * d[prev]) / denom;
+                }
+
+                //backward iteration
+                x[prev + 1] = d[prev];
+                for (std::size_t i = prev; i >= j + count; i -= count)
+                    x[i - count + 1] = d[i - count] - c[i - count] * x[i + 1];
+            }
+        };
+
+        {
+            std::vector<std::jthread> pool;
+            for (std::size_t t = 1; t < threads; t++)
+                pool.emplace_back(work, t);
+            work(0);
+        }
+
+        return x;
+    }
+}
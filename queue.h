@@ -0,0 +1,116 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <optional>
+#include <condition_variable>
+
+//class decl (forward)
+namespace num
+{
+    template<typename T>
+    class bounded_queue;
+}
+
+//class def
+namespace num
+{
+    //FIFO between pipeline stages: push blocks while capacity items are queued, pop blocks while empty;
+    //after close() pushes are dropped and pop returns nothing once the queue is drained
+    template<typename T>
+    class bounded_queue
+    {
+        std::deque<T> _items;
+        std::size_t _capacity;
+        bool _closed = false;
+        mutable std::mutex _mutex;
+        std::condition_variable _not_full, _not_empty;
+
+    public:
+        explicit bounded_queue(std::size_t capacity);
+        bounded_queue(const bounded_queue &other) = delete;
+        bounded_queue &operator=(const bounded_queue &other) = delete;
+
+        bool push(T item);
+        std::optional<T> pop();
+        std::vector<T> pop_some(std::size_t count);
+        void close();
+
+        std::size_t size() const;
+    };
+}
+
+//func def
+namespace num
+{
+    template<typename T>
+    bounded_queue<T>::bounded_queue(std::size_t capacity)
+        : _capacity(std::max<std::size_t>(capacity, 1)) {}
+
+    template<typename T>
+    bool bounded_queue<T>::push(T item)
+    {
+        {
+            std::unique_lock lock(_mutex);
+            _not_full.wait(lock, [this]() { return _closed || _items.size() < _capacity; });
+            if (_closed)
+                return false;
+            _items.push_back(std::move(item));
+        }
+        _not_empty.notify_one();
+        return true;
+    }
+
+    template<typename T>
+    std::optional<T> bounded_queue<T>::pop()
+    {
+        std::optional<T> res;
+        {
+            std::unique_lock lock(_mutex);
+            _not_empty.wait(lock, [this]() { return _closed || !_items.empty(); });
+            if (_items.empty())
+                return res;
+            res = std::move(_items.front());
+            _items.pop_front();
+        }
+        _not_full.notify_one();
+        return res;
+    }
+
+    //blocks like pop, then takes up to count items that are already queued; empty once closed and drained
+    template<typename T>
+    std::vector<T> bounded_queue<T>::pop_some(std::size_t count)
+    {
+        std::vector<T> res;
+        {
+            std::unique_lock lock(_mutex);
+            _not_empty.wait(lock, [this]() { return _closed || !_items.empty(); });
+            while (!_items.empty() && res.size() < count)
+            {
+                res.push_back(std::move(_items.front()));
+                _items.pop_front();
+            }
+        }
+        _not_full.notify_all();
+        return res;
+    }
+
+    template<typename T>
+    void bounded_queue<T>::close()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _closed = true;
+        }
+        _not_full.notify_all();
+        _not_empty.notify_all();
+    }
+
+    template<typename T>
+    std::size_t bounded_queue<T>::size() const
+    {
+        std::lock_guard lock(_mutex);
+        return _items.size();
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <concepts>
+#include <algorithm>
+
+//class / func decl (forward)
+namespace num
+{
+    struct random_key;
+
+    constexpr std::uint64_t splitmix(std::uint64_t x);
+
+    template<std::floating_point T>
+    constexpr T uniform(const random_key &key, std::uint64_t i, const T &min, const T &max);
+
+    template<std::floating_point T>
+    void fill_uniform(T *first, std::size_t count, const T &min, const T &max, const random_key &key,
+                      std::size_t threads = std::thread::hardware_concurrency());
+}
+
+//class def
+namespace num
+{
+    //identifies a reproducible random sequence: element i of (seed, stream) is a pure function of the three,
+    //so any range of it can be generated independently
+    struct random_key
+    {
+        std::uint64_t seed = 0, stream = 0;
+    };
+}
+
+//func def
+namespace num
+{
+    //SplitMix64 finalizer
+    constexpr std::uint64_t splitmix(std::uint64_t x)
+    {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return x ^ (x >> 31);
+    }
+
+    template<std::floating_point T>
+    constexpr T uniform(const random_key &key, std::uint64_t i, const T &min, const T &max)
+    {
+        constexpr int bits = std::numeric_limits<T>::digits < 64 ? std::numeric_limits<T>::digits : 64;
+        std::uint64_t base = splitmix(key.seed ^ splitmix(key.stream + 0x9e3779b97f4a7c15));
+        std::uint64_t x = splitmix(base + (i + 1) * 0x9e3779b97f4a7c15);
+        T unit = T(x >> (64 - bits)) / T(std::uint64_t(1) << (bits - 1)) / 2;
+        return min + (max - min) * unit;
+    }
+
+    template<std::floating_point T>
+    void fill_uniform(T *first, std::size_t count, const T &min, const T &max, const random_key &key, std::size_t threads)
+    {
+        auto work = [=](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; i++)
+                first[i] = uniform(key, i, min, max);
+        };
+
+        threads = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(1, count / (1 << 16)));
+        std::vector<std::jthread> pool;
+        for (std::size_t t = 1; t < threads; t++)
+            pool.emplace_back(work, count * t / threads, count * (t + 1) / threads);
+        work(0, count / threads);
+    }
+}
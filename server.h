@@ -0,0 +1,507 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <algorithm>
+
+#include "solve.h"
+#include "batch.h"
+#include "queue.h"
+
+//unix domain sockets only
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+//class / func decl (forward)
+namespace num::net
+{
+    //frames are a header followed by payload, both in native byte order (the socket is local):
+    //solve     element = sizeof(T), size = n, payload a (n - 1), b (n), c (n - 1), d (n) of T
+    //solution  same element and size, payload x (n), replies to solve with the same id
+    //error     no payload, replies to a solve that was rejected or whose matrix is singular
+    //stats     no payload, replied by stats with payload server_stats
+    //shutdown  no payload, server finishes queued work and exits
+    enum class frame_kind : std::uint16_t
+    {
+        solve = 1,
+        solution,
+        error,
+        stats,
+        shutdown
+    };
+
+    inline constexpr std::uint32_t frame_magic = 0x54444753;    //"SGDT"
+    inline constexpr std::uint64_t max_payload = std::uint64_t(1) << 32;
+
+    struct frame_header;
+    struct server_stats;
+    struct server_options;
+    class solve_server;
+
+    bool send_all(int fd, const void *data, std::size_t bytes);
+    bool recv_all(int fd, void *data, std::size_t bytes);
+    bool send_frame(int fd, const frame_header &head, const void *payload = nullptr, std::size_t bytes = 0);
+    std::size_t payload_size(const frame_header &head);
+
+    int connect_unix(const std::string &path);
+
+    std::ostream &operator<<(std::ostream &out, const server_stats &stats);
+}
+
+//class def
+namespace num::net
+{
+    struct frame_header
+    {
+        std::uint32_t magic = frame_magic;
+        frame_kind kind = frame_kind::solve;
+        std::uint16_t element = 0;
+        std::uint64_t id = 0;
+        std::uint64_t size = 0;
+    };
+
+    //latencies in microseconds from the moment a request is read until its reply is sent,
+    //over the most recent latency_samples requests
+    struct server_stats
+    {
+        std::uint64_t requests = 0, rejected = 0, singular = 0;
+        std::uint64_t batches = 0, batched = 0;             //thomas_batch calls and systems solved by them
+        std::uint64_t queue_depth = 0, max_queue_depth = 0;
+        std::uint64_t connections = 0;
+        double p50 = 0, p90 = 0, p99 = 0, max = 0;
+    };
+
+    struct server_options
+    {
+        std::size_t threads = 1;
+        std::size_t queue = 1024;           //requests waiting for a worker, readers block beyond it
+        std::size_t max_batch = 64;         //requests a worker takes at once
+        std::size_t batch_size = 4096;      //systems up to this size that arrive together share a thomas_batch
+        std::size_t warm_size = 1 << 16;    //rows reserved in every worker workspace up front
+    };
+
+    //resident solver: a reader thread per connection queues solve requests, workers take whatever is queued,
+    //solve equal small systems together and the rest one by one in their own workspaces and reply
+    //on the requesting connection as soon as each solution is ready
+    class solve_server
+    {
+        struct connection
+        {
+            int fd;
+            std::mutex write;
+
+            explicit connection(int fd);
+            ~connection();
+        };
+
+        struct job
+        {
+            std::shared_ptr<connection> conn;
+            frame_header head;
+            std::unique_ptr<std::byte[]> payload;
+            std::chrono::steady_clock::time_point arrival = {};
+        };
+
+        static constexpr std::size_t latency_samples = 4096;
+
+        std::string _path;
+        server_options _options;
+        int _listen = -1;
+        std::atomic<bool> _running = false;
+
+        bounded_queue<job> _queue;
+        std::vector<std::jthread> _workers;
+        std::mutex _connections_mutex;
+        std::vector<std::pair<std::weak_ptr<connection>, std::jthread>> _connections;   //closed with the last reply
+
+        mutable std::mutex _stats_mutex;
+        server_stats _stats;
+        std::vector<double> _latencies;
+        std::size_t _next_latency = 0;
+
+        void serve(std::shared_ptr<connection> conn);
+        void work();
+        template<std::floating_point T>
+        void solve_group(std::span<job> jobs, workspace<T> &ws, workspace<T> &batch);
+        void reply(job &item, bool regular);
+
+    public:
+        explicit solve_server(std::string path, server_options options = {});
+        solve_server(const solve_server &other) = delete;
+        solve_server &operator=(const solve_server &other) = delete;
+        ~solve_server();
+
+        bool listen();
+        void run();
+        void stop();
+
+        server_stats stats() const;
+    };
+}
+
+//func def
+namespace num::net
+{
+    inline bool send_all(int fd, const void *data, std::size_t bytes)
+    {
+        auto *pos = static_cast<const char *>(data);
+        while (bytes > 0)
+        {
+            ssize_t sent = ::send(fd, pos, bytes, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR)
+                continue;
+            if (sent <= 0)
+                return false;
+            pos += sent;
+            bytes -= sent;
+        }
+        return true;
+    }
+
+    inline bool recv_all(int fd, void *data, std::size_t bytes)
+    {
+        auto *pos = static_cast<char *>(data);
+        while (bytes > 0)
+        {
+            ssize_t got = ::recv(fd, pos, bytes, 0);
+            if (got < 0 && errno == EINTR)
+                continue;
+            if (got <= 0)
+                return false;
+            pos += got;
+            bytes -= got;
+        }
+        return true;
+    }
+
+    inline bool send_frame(int fd, const frame_header &head, const void *payload, std::size_t bytes)
+    {
+        return send_all(fd, &head, sizeof(head)) && (bytes == 0 || send_all(fd, payload, bytes));
+    }
+
+    //bytes following head, 0 for a malformed solve frame
+    inline std::size_t payload_size(const frame_header &head)
+    {
+        if (head.kind != frame_kind::solve && head.kind != frame_kind::solution)
+            return 0;
+        if ((head.element != sizeof(float) && head.element != sizeof(double)) ||
+            head.size < 1 || head.size > max_payload / head.element / 4)
+            return 0;
+        return head.element * (head.kind == frame_kind::solve ? 4 * head.size - 2 : head.size);
+    }
+
+    inline int connect_unix(const std::string &path)
+    {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path))
+            return -1;
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.data(), path.size());
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+
+    inline solve_server::connection::connection(int fd)
+        : fd(fd) {}
+
+    inline solve_server::connection::~connection()
+    {
+        ::close(fd);
+    }
+
+    inline solve_server::solve_server(std::string path, server_options options)
+        : _path(std::move(path)), _options(options), _queue(options.queue)
+    {
+        _options.threads = std::max<std::size_t>(_options.threads, 1);
+        _options.max_batch = std::max<std::size_t>(_options.max_batch, 1);
+    }
+
+    inline solve_server::~solve_server()
+    {
+        if (_listen >= 0)
+        {
+            ::close(_listen);
+            ::unlink(_path.c_str());
+        }
+    }
+
+    //a stale socket file left by a killed server is replaced
+    inline bool solve_server::listen()
+    {
+        sockaddr_un addr{};
+        if (_path.size() >= sizeof(addr.sun_path))
+            return false;
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, _path.data(), _path.size());
+
+        ::unlink(_path.c_str());
+        _listen = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (_listen < 0)
+            return false;
+        if (::bind(_listen, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(_listen, 64) != 0)
+        {
+            ::close(_listen);
+            _listen = -1;
+            return false;
+        }
+        _running = true;
+        return true;
+    }
+
+    //accepts connections until stop(), then lets readers end and workers drain the queue
+    inline void solve_server::run()
+    {
+        for (std::size_t t = 0; t < _options.threads; t++)
+            _workers.emplace_back([this]() { work(); });
+
+        while (_running)
+        {
+            int fd = ::accept4(_listen, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+                break;
+            }
+
+            auto conn = std::make_shared<connection>(fd);
+            std::lock_guard lock(_connections_mutex);
+            std::erase_if(_connections, [](auto &entry) { return entry.first.expired(); });
+            _connections.emplace_back(conn, std::jthread([this, conn]() { serve(conn); }));
+            std::lock_guard stats_lock(_stats_mutex);
+            _stats.connections++;
+        }
+
+        {
+            std::lock_guard lock(_connections_mutex);
+            for (auto &entry : _connections)
+                if (auto conn = entry.first.lock())
+                    ::shutdown(conn->fd, SHUT_RD);
+            _connections.clear();
+        }
+        _queue.close();
+        _workers.clear();
+    }
+
+    inline void solve_server::stop()
+    {
+        _running = false;
+        ::shutdown(_listen, SHUT_RDWR);
+    }
+
+    inline server_stats solve_server::stats() const
+    {
+        std::vector<double> sorted;
+        server_stats res;
+        {
+            std::lock_guard lock(_stats_mutex);
+            res = _stats;
+            sorted = _latencies;
+        }
+        res.queue_depth = _queue.size();
+
+        std::ranges::sort(sorted);
+        auto rank = [&](double p) { return sorted[std::min(sorted.size() - 1, std::size_t(p * sorted.size()))]; };
+        if (!sorted.empty())
+        {
+            res.p50 = rank(0.5);
+            res.p90 = rank(0.9);
+            res.p99 = rank(0.99);
+            res.max = sorted.back();
+        }
+        return res;
+    }
+
+    //reads frames of one connection until it is closed; a malformed frame is answered by error and ends it.
+    //the socket is closed once this and every queued job of the connection let go of it
+    inline void solve_server::serve(std::shared_ptr<connection> conn)
+    {
+        frame_header head;
+        while (recv_all(conn->fd, &head, sizeof(head)) && head.magic == frame_magic)
+        {
+            if (head.kind == frame_kind::stats)
+            {
+                auto res = stats();
+                std::lock_guard lock(conn->write);
+                if (!send_frame(conn->fd, { .kind = frame_kind::stats, .id = head.id, .size = sizeof(res) }, &res, sizeof(res)))
+                    break;
+                continue;
+            }
+            if (head.kind == frame_kind::shutdown)
+            {
+                stop();
+                break;
+            }
+
+            std::size_t bytes = payload_size(head);
+            if (head.kind != frame_kind::solve || bytes == 0)
+            {
+                {
+                    std::lock_guard lock(_stats_mutex);
+                    _stats.rejected++;
+                }
+                std::lock_guard lock(conn->write);
+                send_frame(conn->fd, { .kind = frame_kind::error, .element = head.element, .id = head.id });
+                break;
+            }
+
+            job item{ conn, head, std::make_unique_for_overwrite<std::byte[]>(bytes) };
+            if (!recv_all(conn->fd, item.payload.get(), bytes))
+                break;
+            item.arrival = std::chrono::steady_clock::now();
+            if (!_queue.push(std::move(item)))
+                break;
+
+            std::uint64_t depth = _queue.size();
+            std::lock_guard lock(_stats_mutex);
+            _stats.max_queue_depth = std::max(_stats.max_queue_depth, depth);
+        }
+    }
+
+    //requests taken together are ordered by precision and size, so equal small systems end up adjacent
+    inline void solve_server::work()
+    {
+        //pre-warmed per worker: solver scratch, and interleaved a, b, c, d of the largest possible batch
+        std::size_t batch_rows = _options.batch_size * _options.max_batch;
+        workspace<double> ws_double(std::max(_options.warm_size, batch_rows)), batch_double(4 * batch_rows);
+        workspace<float> ws_float(std::max(_options.warm_size, batch_rows)), batch_float(4 * batch_rows);
+        while (true)
+        {
+            auto jobs = _queue.pop_some(_options.max_batch);
+            if (jobs.empty())
+                return;
+
+            std::ranges::sort(jobs, [](const job &lhs, const job &rhs)
+            {
+                return std::pair(lhs.head.element, lhs.head.size) < std::pair(rhs.head.element, rhs.head.size);
+            });
+            for (std::size_t first = 0, last; first < jobs.size(); first = last)
+            {
+                last = first + 1;
+                while (last < jobs.size() && jobs[last].head.element == jobs[first].head.element &&
+                       jobs[last].head.size == jobs[first].head.size)
+                    last++;
+
+                std::span<job> group(jobs.data() + first, last - first);
+                if (group[0].head.element == sizeof(double))
+                    solve_group<double>(group, ws_double, batch_double);
+                else
+                    solve_group<float>(group, ws_float, batch_float);
+            }
+        }
+    }
+
+    //systems of one size and precision: several small diagonally dominant ones share a thomas_batch,
+    //which does not pivot, the rest go through num::solve in place of d; batches are laid out in batch
+    template<std::floating_point T>
+    void solve_server::solve_group(std::span<job> jobs, workspace<T> &ws, workspace<T> &batch)
+    {
+        std::size_t n = jobs[0].head.size, m = 0;
+        auto part = [n](job &item, std::size_t k)
+        {
+            T *data = reinterpret_cast<T *>(item.payload.get());
+            std::size_t offsets[] = { 0, n - 1, 2 * n - 1, 3 * n - 2 };
+            return data + offsets[k];
+        };
+
+        if (jobs.size() > 1 && n <= _options.batch_size)
+        {
+            auto rest = std::ranges::partition(jobs, [&](job &item)
+            {
+                return diagonally_dominant<T>({ part(item, 0), n - 1 }, { part(item, 1), n }, { part(item, 2), n - 1 });
+            });
+            m = jobs.size() - rest.size();
+        }
+
+        //a single dominant system gains nothing from the batch layout
+        if (m < 2)
+            m = 0;
+        if (m > 0)
+        {
+            T *buffer = batch.reserve(4 * n * m);
+            multivector_view<T> a(buffer, n - 1, m, m, 2), b(buffer + (n - 1) * m, n, m, m),
+                                c(buffer + (2 * n - 1) * m, n - 1, m, m), x(buffer + (3 * n - 2) * m, n, m, m);
+            for (std::size_t k = 0; k < m; k++)
+            {
+                const T *ak = part(jobs[k], 0), *bk = part(jobs[k], 1), *ck = part(jobs[k], 2), *dk = part(jobs[k], 3);
+                for (std::size_t i = 1; i <= n; i++)
+                {
+                    if (i > 1)
+                        a[i][k] = ak[i - 2];
+                    b[i][k] = bk[i - 1];
+                    if (i < n)
+                        c[i][k] = ck[i - 1];
+                    x[i][k] = dk[i - 1];
+                }
+            }
+            thomas_batch(tridiag_batch_view<T>(a, b, c), x, x, ws);
+            for (std::size_t k = 0; k < m; k++)
+            {
+                T *d = part(jobs[k], 3);
+                for (std::size_t i = 1; i <= n; i++)
+                    d[i - 1] = x[i][k];
+                reply(jobs[k], true);
+            }
+
+            std::lock_guard lock(_stats_mutex);
+            _stats.batches++;
+            _stats.batched += m;
+        }
+
+        for (auto &item : jobs.subspan(m))
+        {
+            std::span<T> d(part(item, 3), n);
+            bool regular = solve<T>({ part(item, 0), n - 1 }, { part(item, 1), n }, { part(item, 2), n - 1 }, d, d, ws);
+            reply(item, regular);
+        }
+    }
+
+    //solution is the d part at the end of the payload, a singular system is answered by error
+    inline void solve_server::reply(job &item, bool regular)
+    {
+        frame_header head{ .kind = regular ? frame_kind::solution : frame_kind::error,
+                           .element = item.head.element, .id = item.head.id, .size = item.head.size };
+        std::size_t bytes = regular ? item.head.size * item.head.element : 0;
+        const std::byte *x = item.payload.get() + payload_size(item.head) - bytes;
+        {
+            std::lock_guard lock(item.conn->write);
+            send_frame(item.conn->fd, head, x, bytes);
+        }
+
+        std::chrono::duration<double, std::micro> latency = std::chrono::steady_clock::now() - item.arrival;
+        std::lock_guard lock(_stats_mutex);
+        _stats.requests++;
+        _stats.singular += !regular;
+        if (_latencies.size() < latency_samples)
+            _latencies.push_back(latency.count());
+        else
+            _latencies[_next_latency] = latency.count();
+        _next_latency = (_next_latency + 1) % latency_samples;
+    }
+
+    inline std::ostream &operator<<(std::ostream &out, const server_stats &stats)
+    {
+        auto flags = out.flags();
+        out << std::defaultfloat << std::noshowpos
+            << "requests " << stats.requests << ", rejected " << stats.rejected << ", singular " << stats.singular
+            << ", connections " << stats.connections << std::endl
+            << "batches " << stats.batches << " of " << stats.batched << " systems" << std::endl
+            << "queue depth " << stats.queue_depth << ", max " << stats.max_queue_depth << std::endl
+            << "latency us: p50 " << stats.p50 << ", p90 " << stats.p90
+            << ", p99 " << stats.p99 << ", max " << stats.max << std::endl;
+        out.flags(flags);
+        return out;
+    }
+}
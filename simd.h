@@ -0,0 +1,376 @@
+#pragma once
+
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <concepts>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NUM_SIMD_X86 1
+#endif
+
+//func decl
+namespace num::simd
+{
+    const char *isa();
+
+    template<std::floating_point T>
+    T dot(const T *x, const T *y, std::size_t n);
+    template<std::floating_point T>
+    T max_abs(const T *x, std::size_t n);
+    template<std::floating_point T>
+    void axpy(const T &alpha, const T *x, T *y, std::size_t n);
+    template<std::floating_point T>
+    void matvec(const T *a, const T *b, const T *c, const T *x, T *res, std::size_t n);
+    template<std::floating_point T>
+    void residual(const T *a, const T *b, const T *c, const T *x, const T *d, std::size_t n, T &max, T &two);
+}
+
+//func def
+namespace num::simd
+{
+    //width-generic kernels over GCC vector extensions of B bytes; they are always inlined
+    //into per-ISA entry points below, so each one is compiled for AVX-512, AVX2 and SSE2
+    namespace detail
+    {
+        //row i of A * x - d, 0-based diagonals
+        template<typename T>
+        inline T residual_row(const T *a, const T *b, const T *c, const T *x, const T *d, std::size_t n, std::size_t i)
+        {
+            T r = b[i] * x[i] - d[i];
+            if (i > 0)
+                r += a[i - 1] * x[i - 1];
+            if (i + 1 < n)
+                r += c[i] * x[i + 1];
+            return r;
+        }
+
+        //2-norm of the residual from max |r[i]| and the unscaled sum of squares; if that sum overflowed or may
+        //have underflowed, a second pass sums (r[i] / max)^2 instead, scaling by the largest entry as LAPACK xNRM2
+        template<typename T>
+        T residual_two(const T *a, const T *b, const T *c, const T *x, const T *d, std::size_t n, T max, T squares)
+        {
+            if (!std::isfinite(max))
+                return max;
+            if (max == 0 || (squares <= std::numeric_limits<T>::max() && max >= std::sqrt(std::numeric_limits<T>::min())))
+                return std::sqrt(squares);
+            T scaled = 0;
+            for (std::size_t i = 0; i < n; i++)
+            {
+                T r = residual_row(a, b, c, x, d, n, i) / max;
+                scaled += r * r;
+            }
+            return max * std::sqrt(scaled);
+        }
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+        template<typename T, std::size_t B>
+        using pack [[gnu::vector_size(B)]] = T;
+
+        template<typename T, std::size_t B>
+        [[gnu::always_inline]] inline pack<T, B> load(const T *ptr)
+        {
+            pack<T, B> res;
+            std::memcpy(&res, ptr, B);
+            return res;
+        }
+
+        template<typename T, std::size_t B>
+        [[gnu::always_inline]] inline void store(T *ptr, const pack<T, B> &val)
+        {
+            std::memcpy(ptr, &val, B);
+        }
+
+        template<typename T, std::size_t B>
+        [[gnu::always_inline]] inline T dot(const T *x, const T *y, std::size_t n)
+        {
+            constexpr std::size_t w = B / sizeof(T);
+            pack<T, B> acc_1{}, acc_2{};
+            std::size_t i = 0;
+            for (; i + 2 * w <= n; i += 2 * w)
+            {
+                acc_1 += load<T, B>(x + i) * load<T, B>(y + i);
+                acc_2 += load<T, B>(x + i + w) * load<T, B>(y + i + w);
+            }
+            acc_1 += acc_2;
+            T res = 0;
+            for (std::size_t k = 0; k < w; k++)
+                res += acc_1[k];
+            for (; i < n; i++)
+                res += x[i] * y[i];
+            return res;
+        }
+
+        //NaN anywhere gives NaN, as in vector::norm
+        template<typename T, std::size_t B>
+        [[gnu::always_inline]] inline T max_abs(const T *x, std::size_t n)
+        {
+            constexpr std::size_t w = B / sizeof(T);
+            pack<T, B> acc{};
+            decltype(acc != acc) nan{};
+            std::size_t i = 0;
+            for (; i + w <= n; i += w)
+            {
+                auto val = load<T, B>(x + i);
+                val = val < 0 ? -val : val;
+                nan |= val != val;
+                acc = val > acc ? val : acc;
+            }
+            T res = 0;
+            for (std::size_t k = 0; k < w; k++)
+            {
+                if (nan[k])
+                    return std::numeric_limits<T>::quiet_NaN();
+                res = std::max(res, acc[k]);
+            }
+            for (; i < n; i++)
+            {
+                if (std::isnan(x[i]))
+                    return x[i];
+                res = std::max(res, std::abs(x[i]));
+            }
+            return res;
+        }
+
+        template<typename T, std::size_t B>
+        [[gnu::always_inline]] inline void axpy(T alpha, const T *x, T *y, std::size_t n)
+        {
+            constexpr std::size_t w = B / sizeof(T);
+            std::size_t i = 0;
+            for (; i + w <= n; i += w)
+                store<T, B>(y + i, load<T, B>(y + i) + alpha * load<T, B>(x + i));
+            for (; i < n; i++)
+                y[i] += alpha * x[i];
+        }
+
+        //0-based diagonals as in span overload of thomas_alg
+        template<typename T, std::size_t B>
+        [[gnu::always_inline]] inline void matvec(const T *a, const T *b, const T *c, const T *x, T *res, std::size_t n)
+        {
+            constexpr std::size_t w = B / sizeof(T);
+            if (n == 1)
+            {
+                res[0] = b[0] * x[0];
+                return;
+            }
+            res[0] = b[0] * x[0] + c[0] * x[1];
+            std::size_t i = 1;
+            for (; i + w < n; i += w)
+                store<T, B>(res + i, load<T, B>(a + i - 1) * load<T, B>(x + i - 1)
+                                     + load<T, B>(b + i) * load<T, B>(x + i)
+                                     + load<T, B>(c + i) * load<T, B>(x + i + 1));
+            for (; i < n - 1; i++)
+                res[i] = a[i - 1] * x[i - 1] + b[i] * x[i] + c[i] * x[i + 1];
+            res[n - 1] = a[n - 2] * x[n - 2] + b[n - 1] * x[n - 1];
+        }
+
+        //r = A * x - d in one pass without storing it: max = max |r[i]| (NaN if any is NaN), two = its 2-norm,
+        //see residual_two; both 0 for n = 0
+        template<typename T, std::size_t B>
+        [[gnu::always_inline]] inline void residual(const T *a, const T *b, const T *c, const T *x, const T *d,
+                                                    std::size_t n, T &max, T &two)
+        {
+            constexpr std::size_t w = B / sizeof(T);
+            pack<T, B> acc_max{}, acc_sq{};
+            decltype(acc_max != acc_max) nan{};
+            bool is_nan = false;
+            T squares = 0;
+            max = two = 0;
+            if (n == 0)
+                return;
+            auto row = [&](std::size_t i)
+            {
+                T r = residual_row(a, b, c, x, d, n, i);
+                is_nan |= std::isnan(r);
+                max = std::max(max, std::abs(r));
+                squares += r * r;
+            };
+
+            row(0);
+            std::size_t i = 1;
+            for (; i + w < n; i += w)
+            {
+                auto r = load<T, B>(a + i - 1) * load<T, B>(x + i - 1)
+                         + load<T, B>(b + i) * load<T, B>(x + i)
+                         + load<T, B>(c + i) * load<T, B>(x + i + 1) - load<T, B>(d + i);
+                nan |= r != r;
+                acc_sq += r * r;
+                r = r < 0 ? -r : r;
+                acc_max = r > acc_max ? r : acc_max;
+            }
+            for (; i < n; i++)
+                row(i);
+            for (std::size_t k = 0; k < w; k++)
+            {
+                is_nan |= nan[k] != 0;
+                max = std::max(max, acc_max[k]);
+                squares += acc_sq[k];
+            }
+            if (is_nan)
+                max = std::numeric_limits<T>::quiet_NaN();
+            two = residual_two(a, b, c, x, d, n, max, squares);
+        }
+#pragma GCC diagnostic pop
+#endif
+
+        //entry points per instruction set
+        template<typename T, std::size_t B>
+        struct kernels
+        {
+#ifdef __GNUC__
+            static T dot(const T *x, const T *y, std::size_t n) { return detail::dot<T, B>(x, y, n); }
+            static T max_abs(const T *x, std::size_t n) { return detail::max_abs<T, B>(x, n); }
+            static void axpy(T alpha, const T *x, T *y, std::size_t n) { detail::axpy<T, B>(alpha, x, y, n); }
+            static void matvec(const T *a, const T *b, const T *c, const T *x, T *res, std::size_t n) { detail::matvec<T, B>(a, b, c, x, res, n); }
+            static void residual(const T *a, const T *b, const T *c, const T *x, const T *d, std::size_t n, T &max, T &two) { detail::residual<T, B>(a, b, c, x, d, n, max, two); }
+#endif
+        };
+
+#ifdef NUM_SIMD_X86
+        template<typename T>
+        struct kernels_avx2
+        {
+            [[gnu::target("avx2,fma")]] static T dot(const T *x, const T *y, std::size_t n) { return detail::dot<T, 32>(x, y, n); }
+            [[gnu::target("avx2,fma")]] static T max_abs(const T *x, std::size_t n) { return detail::max_abs<T, 32>(x, n); }
+            [[gnu::target("avx2,fma")]] static void axpy(T alpha, const T *x, T *y, std::size_t n) { detail::axpy<T, 32>(alpha, x, y, n); }
+            [[gnu::target("avx2,fma")]] static void matvec(const T *a, const T *b, const T *c, const T *x, T *res, std::size_t n) { detail::matvec<T, 32>(a, b, c, x, res, n); }
+            [[gnu::target("avx2,fma")]] static void residual(const T *a, const T *b, const T *c, const T *x, const T *d, std::size_t n, T &max, T &two) { detail::residual<T, 32>(a, b, c, x, d, n, max, two); }
+        };
+
+        template<typename T>
+        struct kernels_avx512
+        {
+            [[gnu::target("avx512f")]] static T dot(const T *x, const T *y, std::size_t n) { return detail::dot<T, 64>(x, y, n); }
+            [[gnu::target("avx512f")]] static T max_abs(const T *x, std::size_t n) { return detail::max_abs<T, 64>(x, n); }
+            [[gnu::target("avx512f")]] static void axpy(T alpha, const T *x, T *y, std::size_t n) { detail::axpy<T, 64>(alpha, x, y, n); }
+            [[gnu::target("avx512f")]] static void matvec(const T *a, const T *b, const T *c, const T *x, T *res, std::size_t n) { detail::matvec<T, 64>(a, b, c, x, res, n); }
+            [[gnu::target("avx512f")]] static void residual(const T *a, const T *b, const T *c, const T *x, const T *d, std::size_t n, T &max, T &two) { detail::residual<T, 64>(a, b, c, x, d, n, max, two); }
+        };
+#endif
+
+        //table of kernels for the running CPU, resolved once
+        template<typename T>
+        struct dispatch
+        {
+            T (*dot)(const T *, const T *, std::size_t);
+            T (*max_abs)(const T *, std::size_t);
+            void (*axpy)(T, const T *, T *, std::size_t);
+            void (*matvec)(const T *, const T *, const T *, const T *, T *, std::size_t);
+            void (*residual)(const T *, const T *, const T *, const T *, const T *, std::size_t, T &, T &);
+            const char *isa;
+
+            template<typename K>
+            static dispatch make(const char *isa)
+            {
+                return { &K::dot, &K::max_abs, &K::axpy, &K::matvec, &K::residual, isa };
+            }
+
+            static const dispatch &get()
+            {
+                static const dispatch table = []()
+                {
+#ifdef NUM_SIMD_X86
+                    __builtin_cpu_init();
+                    if (__builtin_cpu_supports("avx512f"))
+                        return make<kernels_avx512<T>>("AVX-512");
+                    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                        return make<kernels_avx2<T>>("AVX2");
+                    return make<kernels<T, 16>>("SSE2");
+#else
+                    return make<kernels<T, 16>>("generic");
+#endif
+                }();
+                return table;
+            }
+        };
+
+#ifdef __GNUC__
+        template<typename T>
+        constexpr bool vectorized = std::same_as<T, float> || std::same_as<T, double>;
+#else
+        template<typename T>
+        constexpr bool vectorized = false;
+#endif
+    }
+
+    inline const char *isa()
+    {
+#ifdef __GNUC__
+        return detail::dispatch<double>::get().isa;
+#else
+        return "scalar";
+#endif
+    }
+
+    template<std::floating_point T>
+    T dot(const T *x, const T *y, std::size_t n)
+    {
+        if constexpr (detail::vectorized<T>)
+            return detail::dispatch<T>::get().dot(x, y, n);
+        T res = 0;
+        for (std::size_t i = 0; i < n; i++)
+            res += x[i] * y[i];
+        return res;
+    }
+
+    template<std::floating_point T>
+    T max_abs(const T *x, std::size_t n)
+    {
+        if constexpr (detail::vectorized<T>)
+            return detail::dispatch<T>::get().max_abs(x, n);
+        T res = 0;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            if (std::isnan(x[i]))
+                return x[i];
+            res = std::max(res, std::abs(x[i]));
+        }
+        return res;
+    }
+
+    template<std::floating_point T>
+    void axpy(const T &alpha, const T *x, T *y, std::size_t n)
+    {
+        if constexpr (detail::vectorized<T>)
+            return detail::dispatch<T>::get().axpy(alpha, x, y, n);
+        for (std::size_t i = 0; i < n; i++)
+            y[i] += alpha * x[i];
+    }
+
+    template<std::floating_point T>
+    void matvec(const T *a, const T *b, const T *c, const T *x, T *res, std::size_t n)
+    {
+        if constexpr (detail::vectorized<T>)
+            return detail::dispatch<T>::get().matvec(a, b, c, x, res, n);
+        if (n == 1)
+        {
+            res[0] = b[0] * x[0];
+            return;
+        }
+        res[0] = b[0] * x[0] + c[0] * x[1];
+        for (std::size_t i = 1; i < n - 1; i++)
+            res[i] = a[i - 1] * x[i - 1] + b[i] * x[i] + c[i] * x[i + 1];
+        res[n - 1] = a[n - 2] * x[n - 2] + b[n - 1] * x[n - 1];
+    }
+
+    template<std::floating_point T>
+    void residual(const T *a, const T *b, const T *c, const T *x, const T *d, std::size_t n, T &max, T &two)
+    {
+        if constexpr (detail::vectorized<T>)
+            return detail::dispatch<T>::get().residual(a, b, c, x, d, n, max, two);
+        T squares = 0;
+        max = 0;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            T r = detail::residual_row(a, b, c, x, d, n, i);
+            if (std::isnan(r))
+                max = r;
+            else if (!std::isnan(max))
+                max = std::max(max, std::abs(r));
+            squares += r * r;
+        }
+        two = detail::residual_two(a, b, c, x, d, n, max, squares);
+    }
+}
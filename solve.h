@@ -1,79 +1,355 @@
 #pragma once
 
+#include <span>
+#include <cmath>
+#include <limits>
+
 #include "tridiag.h"
+#include "workspace.h"
+#include "stats.h"
 
 //func decl
 namespace num
 {
     template <std::floating_point T>
-    vector<T> thomas_alg(tridiag<T> mat, vector<T> vec);
+    vector<T> thomas_alg(const tridiag<T> &mat, const vector<T> &vec);
+    template <std::floating_point T>
+    void thomas_alg(const tridiag<T> &mat, const vector<T> &vec, vector<T> &x, workspace<T> &ws);
+    template <std::floating_point T>
+    void thomas_alg(const tridiag<T> &mat, vector<T> &vec, workspace<T> &ws);
+    template <std::floating_point T>
+    void thomas_alg(std::span<const T> a, std::span<const T> b, std::span<const T> c,
+                    std::span<const T> d, std::span<T> x, workspace<T> &ws);
+
+    template <std::floating_point T>
+    vector<T> unstable_method(const tridiag<T> &mat, const vector<T> &vec);
+    template <std::floating_point T>
+    void unstable_method(const tridiag<T> &mat, const vector<T> &vec, vector<T> &x, workspace<T> &ws);
+    template <std::floating_point T>
+    void unstable_method(const tridiag<T> &mat, vector<T> &vec, workspace<T> &ws);
+    template <std::floating_point T>
+    void unstable_method(std::span<const T> a, std::span<const T> b, std::span<const T> c,
+                         std::span<const T> d, std::span<T> x, workspace<T> &ws);
+
+    template <std::floating_point T>
+    vector<T> pivot_solve(const tridiag<T> &mat, const vector<T> &vec);
+    template <std::floating_point T>
+    bool pivot_solve(const tridiag<T> &mat, const vector<T> &vec, vector<T> &x, workspace<T> &ws);
+    template <std::floating_point T>
+    bool pivot_solve(const tridiag<T> &mat, vector<T> &vec, workspace<T> &ws);
+    template <std::floating_point T>
+    bool pivot_solve(std::span<const T> a, std::span<const T> b, std::span<const T> c,
+                     std::span<const T> d, std::span<T> x, workspace<T> &ws);
+
+    template <std::floating_point T>
+    bool diagonally_dominant(const tridiag<T> &mat);
+    template <std::floating_point T>
+    bool diagonally_dominant(std::span<const T> a, std::span<const T> b, std::span<const T> c);
 
     template <std::floating_point T>
-    vector<T> unstable_method(tridiag<T> mat, vector<T> vec);
+    vector<T> solve(const tridiag<T> &mat, const vector<T> &vec);
+    template <std::floating_point T>
+    bool solve(const tridiag<T> &mat, const vector<T> &vec, vector<T> &x, workspace<T> &ws);
+    template <std::floating_point T>
+    bool solve(const tridiag<T> &mat, vector<T> &vec, workspace<T> &ws);
+    template <std::floating_point T>
+    bool solve(std::span<const T> a, std::span<const T> b, std::span<const T> c,
+               std::span<const T> d, std::span<T> x, workspace<T> &ws);
 }
 
 //func def
 namespace num
 {
-    template <std::floating_point T>
-    vector<T> thomas_alg(tridiag<T> mat, vector<T> vec)
+    //sweeps shared by span and view overloads: a, b, c, d, x are anything indexed from 0
+    namespace solve_detail
     {
-        //aliases
-        auto& a = mat.a;
-        auto& b = mat.b;
-        auto& c = mat.c;
-        auto& d = vec;
+        template <typename V, typename X, std::floating_point T>
+        void thomas(const V &a, const V &b, const V &c, const V &d, X &x, std::size_t n, T *L)
+        {
+            //x holds M during forward iteration, L[i] is the coefficient of x[i + 1]
 
-        //variables & result
-        std::size_t n = mat.size();
-        vector<T> x(n), L(n - 1, 0, 2), M(n, 0, 2);
+            //forward iteration
+            {
+                NUM_STATS_PHASE(forward);
+                NUM_STATS_MOVED(6 * n * sizeof(T));
+                L[0] = n > 1 ? c[0] / b[0] : 0;
+                x[0] = d[0] / b[0];
+                for (std::size_t i = 1; i < n; i++)
+                {
+                    T denom = b[i] - a[i - 1] * L[i - 1];
+                    L[i] = i < n - 1 ? c[i] / denom : 0;
+                    x[i] = (d[i] - a[i - 1] * x[i - 1]) / denom;
+                }
+            }
 
-        //forward iteration
-        L[2] = c[1] / b[1];
-        M[2] = d[1] / b[1];
-        for (std::size_t i = 2; i < n; i++)
+            //backward iteration
+            NUM_STATS_PHASE(backward);
+            NUM_STATS_MOVED(3 * n * sizeof(T));
+            for (std::size_t i = n - 1; i > 0; i--)
+                x[i - 1] -= L[i - 1] * x[i];
+        }
+
+        template <typename V, typename X, std::floating_point T>
+        void unstable(const V &a, const V &b, const V &c, const V &d, X &x, std::size_t n, T *z)
         {
-            L[i + 1] = c[i] / (b[i] - a[i] * L[i]);
-            M[i + 1] = (d[i] - a[i] * M[i]) / (b[i] - a[i] * L[i]);
+            //recurrences below need at least one off-diagonal
+            if (n == 1)
+            {
+                x[0] = d[0] / b[0];
+                return;
+            }
+
+            //variables, x[i] holds y[i + 2] until combined
+            T y_prev = 0, y = 0;
+
+            //calculate y and z, both are forward recurrences
+            {
+                NUM_STATS_PHASE(forward);
+                NUM_STATS_MOVED(9 * n * sizeof(T));
+                for (std::size_t i = 0; i < n - 1; i++)
+                {
+                    T y_next = (d[i] - (i > 0 ? a[i - 1] * y_prev : 0) - b[i] * y) / c[i];
+                    x[i] = y_next;
+                    y_prev = y;
+                    y = y_next;
+                }
+
+                z[0] = 1;
+                z[1] = -b[0] / c[0];
+                for (std::size_t i = 1; i < n - 1; i++)
+                    z[i + 1] = -(a[i - 1] * z[i - 1] + b[i] * z[i]) / c[i];
+            }
+
+            //calculate K
+            NUM_STATS_PHASE(combine);
+            NUM_STATS_MOVED(3 * n * sizeof(T));
+            auto K = (d[n - 1] - a[n - 2] * y_prev - b[n - 1] * y) / (a[n - 2] * z[n - 2] + b[n - 1] * z[n - 1]);
+
+            //x[i] = y[i] + K * z[i], y[i] is stored one position left of x[i]
+            for (std::size_t i = n - 1; i > 0; i--)
+                x[i] = x[i - 1] + K * z[i];
+            x[0] = K * z[0];
         }
-        M[n + 1] = (d[n] - a[n] * M[n]) / (b[n] - a[n] * L[n]);
 
-        //backward iteration
-        x[n] = M[n + 1];
-        for (std::size_t i = n - 1; i > 0; i--)
-            x[i] = M[i + 1] - L[i + 1] * x[i + 1];
+        //LU with partial pivoting as in LAPACK gtsv: rows i and i + 1 are swapped when |a[i]| > |b[i]|,
+        //which fills a second superdiagonal. U is kept in w: diagonal, superdiagonal and fill, n each;
+        //multipliers are applied to x right away. false on a zero pivot, i.e. a singular matrix
+        template <typename V, typename X, std::floating_point T>
+        bool pivoting(const V &a, const V &b, const V &c, const V &d, X &x, std::size_t n, T *w)
+        {
+            T *u0 = w, *u1 = w + n, *u2 = w + 2 * n;
+
+            //forward elimination
+            {
+                NUM_STATS_PHASE(forward);
+                NUM_STATS_MOVED(8 * n * sizeof(T));
+                for (std::size_t i = 0; i < n; i++)
+                {
+                    u0[i] = b[i];
+                    u1[i] = i + 1 < n ? c[i] : 0;
+                    u2[i] = 0;
+                    x[i] = d[i];
+                }
+                for (std::size_t i = 0; i + 1 < n; i++)
+                {
+                    T sub = a[i];
+                    if (std::abs(u0[i]) >= std::abs(sub))
+                    {
+                        if (u0[i] == 0)
+                            return false;
+                        T fact = sub / u0[i];
+                        u0[i + 1] -= fact * u1[i];
+                        x[i + 1] -= fact * x[i];
+                    }
+                    else
+                    {
+                        T fact = u0[i] / sub, next = u0[i + 1], rhs = x[i];
+                        u0[i] = sub;
+                        u0[i + 1] = u1[i] - fact * next;
+                        u1[i] = next;
+                        if (i + 2 < n)
+                        {
+                            u2[i] = u1[i + 1];
+                            u1[i + 1] = -fact * u2[i];
+                        }
+                        x[i] = x[i + 1];
+                        x[i + 1] = rhs - fact * x[i + 1];
+                    }
+                }
+                if (u0[n - 1] == 0)
+                    return false;
+            }
+
+            //back substitution
+            NUM_STATS_PHASE(backward);
+            NUM_STATS_MOVED(5 * n * sizeof(T));
+            for (std::size_t i = n; i-- > 0;)
+            {
+                T sum = x[i];
+                if (i + 1 < n)
+                    sum -= u1[i] * x[i + 1];
+                if (i + 2 < n)
+                    sum -= u2[i] * x[i + 2];
+                x[i] = sum / u0[i];
+            }
+            return true;
+        }
+    }
+    template <std::floating_point T>
+    vector<T> thomas_alg(const tridiag<T> &mat, const vector<T> &vec)
+    {
+        vector<T> x(mat.size());
+        workspace<T> ws;
+        thomas_alg(mat, vec, x, ws);
+        return x;
+    }
+
+    template <std::floating_point T>
+    void thomas_alg(const tridiag<T> &mat, const vector<T> &vec, vector<T> &x, workspace<T> &ws)
+    {
+        x = vec;
+        thomas_alg(mat, x, ws);
+    }
+
+    //solution overwrites vec
+    template <std::floating_point T>
+    void thomas_alg(const tridiag<T> &mat, vector<T> &vec, workspace<T> &ws)
+    {
+        std::size_t n = mat.size();
+        std::span<T> x(vec.data(), n);
+        thomas_alg<T>({ mat.a.data(), n - 1 }, { mat.b.data(), n }, { mat.c.data(), n - 1 }, x, x, ws);
+    }
+
+    //0-based diagonals: row i is a[i - 1] * x[i - 1] + b[i] * x[i] + c[i] * x[i + 1] = d[i];
+    //x may alias d, L coefficients live in ws
+    template <std::floating_point T>
+    void thomas_alg(std::span<const T> a, std::span<const T> b, std::span<const T> c,
+                    std::span<const T> d, std::span<T> x, workspace<T> &ws)
+    {
+        solve_detail::thomas(a, b, c, d, x, b.size(), ws.reserve(b.size()));
+    }
+
+    template <std::floating_point T>
+    vector<T> unstable_method(const tridiag<T> &mat, const vector<T> &vec)
+    {
+        vector<T> x(mat.size());
+        workspace<T> ws;
+        unstable_method(mat, vec, x, ws);
+        return x;
+    }
+
+    template <std::floating_point T>
+    void unstable_method(const tridiag<T> &mat, const vector<T> &vec, vector<T> &x, workspace<T> &ws)
+    {
+        x = vec;
+        unstable_method(mat, x, ws);
+    }
+
+    //solution overwrites vec
+    template <std::floating_point T>
+    void unstable_method(const tridiag<T> &mat, vector<T> &vec, workspace<T> &ws)
+    {
+        std::size_t n = mat.size();
+        std::span<T> x(vec.data(), n);
+        unstable_method<T>({ mat.a.data(), n - 1 }, { mat.b.data(), n }, { mat.c.data(), n - 1 }, x, x, ws);
+    }
+
+    //0-based diagonals as in thomas_alg, x may alias d, z lives in ws
+    template <std::floating_point T>
+    void unstable_method(std::span<const T> a, std::span<const T> b, std::span<const T> c,
+                         std::span<const T> d, std::span<T> x, workspace<T> &ws)
+    {
+        solve_detail::unstable(a, b, c, d, x, b.size(), ws.reserve(b.size()));
+    }
 
+    template <std::floating_point T>
+    vector<T> pivot_solve(const tridiag<T> &mat, const vector<T> &vec)
+    {
+        vector<T> x(mat.size());
+        workspace<T> ws;
+        if (!pivot_solve(mat, vec, x, ws))
+            x = vector<T>(mat.size(), std::numeric_limits<T>::quiet_NaN());
         return x;
     }
 
     template <std::floating_point T>
-    vector<T> unstable_method(tridiag<T> mat, vector<T> vec)
+    bool pivot_solve(const tridiag<T> &mat, const vector<T> &vec, vector<T> &x, workspace<T> &ws)
     {
-        //aliases
-        auto& a = mat.a;
-        auto& b = mat.b;
-        auto& c = mat.c;
-        auto& d = vec;
+        x = vec;
+        return pivot_solve(mat, x, ws);
+    }
 
-        //variables
+    //solution overwrites vec
+    template <std::floating_point T>
+    bool pivot_solve(const tridiag<T> &mat, vector<T> &vec, workspace<T> &ws)
+    {
         std::size_t n = mat.size();
-        vector<T> y(n), z(n);
+        std::span<T> x(vec.data(), n);
+        return pivot_solve<T>({ mat.a.data(), n - 1 }, { mat.b.data(), n }, { mat.c.data(), n - 1 }, x, x, ws);
+    }
 
-        //calculate y
-        y[1] = 0;
-        y[2] = d[1] / c[1];
-        for (std::size_t i = 2; i < n; i++)
-            y[i + 1] = (d[i] - a[i] * y[i - 1] - b[i] * y[i]) / c[i];
+    //0-based diagonals as in thomas_alg, x may alias d, U lives in ws; false for a singular matrix
+    template <std::floating_point T>
+    bool pivot_solve(std::span<const T> a, std::span<const T> b, std::span<const T> c,
+                     std::span<const T> d, std::span<T> x, workspace<T> &ws)
+    {
+        return solve_detail::pivoting(a, b, c, d, x, b.size(), ws.reserve(3 * b.size()));
+    }
 
-        //calculate z
-        z[1] = 1;
-        z[2] = -b[1] / c[1];
-        for (std::size_t i = 2; i < n; i++)
-            z[i + 1] = -(a[i] * z[i - 1] + b[i] * z[i]) / c[i];
+    template <std::floating_point T>
+    bool diagonally_dominant(const tridiag<T> &mat)
+    {
+        std::size_t n = mat.size();
+        return diagonally_dominant<T>({ mat.a.data(), n - 1 }, { mat.b.data(), n }, { mat.c.data(), n - 1 });
+    }
 
-        //calculate K
-        auto K = (d[n] - a[n] * y[n - 1] - b[n] * y[n]) / (a[n] * z[n - 1] + b[n] * z[n]);
+    //strictly by rows: |b[i]| > |a[i - 1]| + |c[i]|, which makes the matrix nonsingular
+    //and keeps Thomas multipliers below 1 without pivoting
+    template <std::floating_point T>
+    bool diagonally_dominant(std::span<const T> a, std::span<const T> b, std::span<const T> c)
+    {
+        std::size_t n = b.size();
+        bool res = true;
+        for (std::size_t i = 0; i < n; i++)
+            res &= std::abs(b[i]) > (i > 0 ? std::abs(a[i - 1]) : 0) + (i + 1 < n ? std::abs(c[i]) : 0);
+        return res;
+    }
 
-        return y + K * z;
+    template <std::floating_point T>
+    vector<T> solve(const tridiag<T> &mat, const vector<T> &vec)
+    {
+        vector<T> x(mat.size());
+        workspace<T> ws;
+        if (!solve(mat, vec, x, ws))
+            x = vector<T>(mat.size(), std::numeric_limits<T>::quiet_NaN());
+        return x;
+    }
+
+    template <std::floating_point T>
+    bool solve(const tridiag<T> &mat, const vector<T> &vec, vector<T> &x, workspace<T> &ws)
+    {
+        x = vec;
+        return solve(mat, x, ws);
+    }
+
+    //solution overwrites vec
+    template <std::floating_point T>
+    bool solve(const tridiag<T> &mat, vector<T> &vec, workspace<T> &ws)
+    {
+        std::size_t n = mat.size();
+        std::span<T> x(vec.data(), n);
+        return solve<T>({ mat.a.data(), n - 1 }, { mat.b.data(), n }, { mat.c.data(), n - 1 }, x, x, ws);
+    }
+
+    //general front end: Thomas algorithm for diagonally dominant matrices, pivoting LU for the rest;
+    //false for a singular matrix
+    template <std::floating_point T>
+    bool solve(std::span<const T> a, std::span<const T> b, std::span<const T> c,
+               std::span<const T> d, std::span<T> x, workspace<T> &ws)
+    {
+        if (!diagonally_dominant(a, b, c))
+            return pivot_solve(a, b, c, d, x, ws);
+        thomas_alg(a, b, c, d, x, ws);
+        return true;
     }
 }
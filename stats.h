@@ -0,0 +1,279 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <iomanip>
+
+//instrumentation is compiled in only with NUM_STATS defined, perf counters additionally need NUM_STATS_PERF;
+//without NUM_STATS the macros below expand to nothing and the api reports zeros
+#if defined(NUM_STATS) && defined(NUM_STATS_PERF) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define NUM_HAS_PERF 1
+#endif
+
+#ifdef NUM_STATS
+#define NUM_STATS_JOIN_(a, b) a##b
+#define NUM_STATS_JOIN(a, b) NUM_STATS_JOIN_(a, b)
+#define NUM_STATS_PHASE(name) ::num::stats::scope NUM_STATS_JOIN(num_stats_scope_, __LINE__)(::num::stats::phase::name)
+#define NUM_STATS_MOVED(bytes) ::num::stats::moved(bytes)
+#define NUM_STATS_ALLOCATED(bytes) ::num::stats::allocated(bytes)
+#else
+#define NUM_STATS_PHASE(name) ((void) 0)
+#define NUM_STATS_MOVED(bytes) ((void) 0)
+#define NUM_STATS_ALLOCATED(bytes) ((void) 0)
+#endif
+
+//class / func decl (forward)
+namespace num::stats
+{
+    enum class phase
+    {
+        allocation,
+        forward,
+        backward,
+        combine
+    };
+    inline constexpr std::size_t phase_count = 4;
+    inline constexpr const char *phase_names[phase_count] = { "allocation", "forward", "backward", "combine" };
+
+    struct report;
+    class scope;
+    class perf_scope;
+
+    constexpr bool enabled();
+    report snapshot();
+    void reset();
+
+    void record(phase ph, std::uint64_t ns);
+    void allocated(std::uint64_t bytes);
+    void moved(std::uint64_t bytes);
+
+    std::ostream &operator<<(std::ostream &out, const report &rep);
+}
+
+//class def
+namespace num::stats
+{
+    //totals since the last reset over all threads
+    struct report
+    {
+        std::array<std::uint64_t, phase_count> ns{}, calls{};
+        std::uint64_t allocations = 0, allocated_bytes = 0;
+        std::uint64_t bytes_moved = 0;     //estimate: every array element read or written once per sweep
+
+        bool perf = false;                 //counters below are valid
+        std::uint64_t cycles = 0, instructions = 0, cache_misses = 0, branch_misses = 0;
+    };
+
+    //adds its lifetime to phase ph
+    class scope
+    {
+#ifdef NUM_STATS
+        phase _phase;
+        std::chrono::steady_clock::time_point _start;
+#endif
+
+    public:
+        explicit scope(phase ph);
+        scope(const scope &other) = delete;
+        scope &operator=(const scope &other) = delete;
+        ~scope();
+    };
+
+    //hardware counters of the calling thread over its lifetime, through perf_event_open;
+    //does nothing when counters are not compiled in or the kernel refuses them
+    class perf_scope
+    {
+#ifdef NUM_HAS_PERF
+        std::array<int, 4> _fds{ -1, -1, -1, -1 };
+#endif
+
+    public:
+        perf_scope();
+        perf_scope(const perf_scope &other) = delete;
+        perf_scope &operator=(const perf_scope &other) = delete;
+        ~perf_scope();
+    };
+}
+
+//func def
+namespace num::stats
+{
+    namespace detail
+    {
+        struct counters
+        {
+            std::array<std::atomic<std::uint64_t>, phase_count> ns{}, calls{};
+            std::atomic<std::uint64_t> allocations = 0, allocated_bytes = 0, bytes_moved = 0;
+            std::atomic<bool> perf = false;
+            std::array<std::atomic<std::uint64_t>, 4> hardware{};
+        };
+
+        inline counters &global()
+        {
+            static counters res;
+            return res;
+        }
+    }
+
+    constexpr bool enabled()
+    {
+#ifdef NUM_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    inline report snapshot()
+    {
+        report res;
+#ifdef NUM_STATS
+        auto &cnt = detail::global();
+        for (std::size_t k = 0; k < phase_count; k++)
+        {
+            res.ns[k] = cnt.ns[k].load(std::memory_order_relaxed);
+            res.calls[k] = cnt.calls[k].load(std::memory_order_relaxed);
+        }
+        res.allocations = cnt.allocations.load(std::memory_order_relaxed);
+        res.allocated_bytes = cnt.allocated_bytes.load(std::memory_order_relaxed);
+        res.bytes_moved = cnt.bytes_moved.load(std::memory_order_relaxed);
+        res.perf = cnt.perf.load(std::memory_order_relaxed);
+        res.cycles = cnt.hardware[0].load(std::memory_order_relaxed);
+        res.instructions = cnt.hardware[1].load(std::memory_order_relaxed);
+        res.cache_misses = cnt.hardware[2].load(std::memory_order_relaxed);
+        res.branch_misses = cnt.hardware[3].load(std::memory_order_relaxed);
+#endif
+        return res;
+    }
+
+    inline void reset()
+    {
+#ifdef NUM_STATS
+        auto &cnt = detail::global();
+        for (std::size_t k = 0; k < phase_count; k++)
+        {
+            cnt.ns[k] = 0;
+            cnt.calls[k] = 0;
+        }
+        cnt.allocations = cnt.allocated_bytes = cnt.bytes_moved = 0;
+        cnt.perf = false;
+        for (auto &val : cnt.hardware)
+            val = 0;
+#endif
+    }
+
+    inline void record([[maybe_unused]] phase ph, [[maybe_unused]] std::uint64_t ns)
+    {
+#ifdef NUM_STATS
+        auto &cnt = detail::global();
+        cnt.ns[std::size_t(ph)].fetch_add(ns, std::memory_order_relaxed);
+        cnt.calls[std::size_t(ph)].fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    inline void allocated([[maybe_unused]] std::uint64_t bytes)
+    {
+#ifdef NUM_STATS
+        auto &cnt = detail::global();
+        cnt.allocations.fetch_add(1, std::memory_order_relaxed);
+        cnt.allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+#endif
+    }
+
+    inline void moved([[maybe_unused]] std::uint64_t bytes)
+    {
+#ifdef NUM_STATS
+        detail::global().bytes_moved.fetch_add(bytes, std::memory_order_relaxed);
+#endif
+    }
+
+#ifdef NUM_STATS
+    inline scope::scope(phase ph)
+        : _phase(ph), _start(std::chrono::steady_clock::now()) {}
+
+    inline scope::~scope()
+    {
+        std::chrono::nanoseconds time = std::chrono::steady_clock::now() - _start;
+        record(_phase, time.count());
+    }
+#else
+    inline scope::scope(phase) {}
+
+    inline scope::~scope() {}
+#endif
+
+#ifdef NUM_HAS_PERF
+    //events are opened as one group led by cycles, so they count over the same interval
+    inline perf_scope::perf_scope()
+    {
+        constexpr std::uint64_t events[] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                             PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+        for (std::size_t k = 0; k < _fds.size(); k++)
+        {
+            perf_event_attr attr{};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = events[k];
+            attr.disabled = k == 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            _fds[k] = syscall(SYS_perf_event_open, &attr, 0, -1, k == 0 ? -1 : _fds[0], 0);
+            if (_fds[k] < 0)
+                return;
+        }
+        ioctl(_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    inline perf_scope::~perf_scope()
+    {
+        bool valid = _fds[_fds.size() - 1] >= 0;
+        if (valid)
+            ioctl(_fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        auto &cnt = detail::global();
+        for (std::size_t k = 0; k < _fds.size(); k++)
+        {
+            if (_fds[k] < 0)
+                continue;
+            std::uint64_t val = 0;
+            if (valid && read(_fds[k], &val, sizeof(val)) == sizeof(val))
+                cnt.hardware[k].fetch_add(val, std::memory_order_relaxed);
+            close(_fds[k]);
+        }
+        if (valid)
+            cnt.perf = true;
+    }
+#else
+    inline perf_scope::perf_scope() {}
+
+    inline perf_scope::~perf_scope() {}
+#endif
+
+    inline std::ostream &operator<<(std::ostream &out, const report &rep)
+    {
+        if (!enabled())
+            return out << "Statistics are not compiled in (define NUM_STATS)." << std::endl;
+
+        auto flags = out.flags();
+        auto precision = out.precision(4);
+        out << std::defaultfloat << std::noshowpos;
+        for (std::size_t k = 0; k < phase_count; k++)
+            out << std::left << std::setw(12) << phase_names[k] << std::right
+                << std::setw(12) << rep.calls[k] << " calls" << std::setw(16) << rep.ns[k] / 1e6 << " ms" << std::endl;
+        out << "allocations " << rep.allocations << " (" << rep.allocated_bytes << " bytes)" << std::endl
+            << "bytes moved " << rep.bytes_moved << " (estimate)" << std::endl;
+        if (rep.perf)
+            out << "cycles " << rep.cycles << ", instructions " << rep.instructions
+                << ", cache misses " << rep.cache_misses << ", branch misses " << rep.branch_misses << std::endl;
+        out.flags(flags);
+        out.precision(precision);
+        return out;
+    }
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <future>
+#include <array>
+#include <algorithm>
+
+#include "binary.h"
+
+//func decl
+namespace num
+{
+    template <std::floating_point T>
+    bool thomas_stream(const std::string &system_path, const std::string &solution_path,
+                       const std::string &scratch_path, std::size_t chunk = 1 << 20);
+}
+
+//func def
+namespace num
+{
+    //out-of-core Thomas algorithm over a binary system file: forward iteration streams a, b, c, d in chunks
+    //of rows and spills (L, M) pairs to scratch file, backward iteration reads them in reverse chunks
+    //and writes x as a raw array of n values; next chunk is always read asynchronously while current is computed.
+    //false for chunk == 0, chunks longer than the system are cut to it
+    template <std::floating_point T>
+    bool thomas_stream(const std::string &system_path, const std::string &solution_path,
+                       const std::string &scratch_path, std::size_t chunk)
+    {
+        binary_header header;
+        {
+            std::ifstream in(system_path, std::ios::binary);
+            if (!in.read(reinterpret_cast<char *>(&header), sizeof(header))
+                || std::memcmp(header.magic, binary_header::signature, sizeof(header.magic)) != 0
+                || header.version != binary_header::current_version
+                || header.scalar != sizeof(T)
+                || header.little_endian != (std::endian::native == std::endian::little)
+                || header.size < 1 || chunk == 0)
+                return false;
+        }
+
+        //variables, 0-based rows as in span overload of thomas_alg
+        chunk = std::min<std::size_t>(chunk, header.size);
+        std::size_t n = header.size, chunks = (n + chunk - 1) / chunk;
+        std::streamoff off_a = sizeof(header),
+                       off_b = off_a + (n - 1) * sizeof(T),
+                       off_c = off_b + n * sizeof(T),
+                       off_d = off_c + (n - 1) * sizeof(T);
+
+        auto read = [](std::ifstream &in, std::streamoff offset, T *dst, std::size_t count)
+        {
+            in.seekg(offset);
+            in.read(reinterpret_cast<char *>(dst), count * sizeof(T));
+            return count == 0 || in.good();
+        };
+
+        //double buffered chunks, each with own stream so that reads can overlap
+        struct buffer
+        {
+            std::vector<T> a, b, c, d;
+            std::ifstream in;
+        };
+        std::array<buffer, 2> buffers;
+        for (auto &buf : buffers)
+        {
+            buf.a.resize(chunk);
+            buf.b.resize(chunk);
+            buf.c.resize(chunk);
+            buf.d.resize(chunk);
+            buf.in.open(system_path, std::ios::binary);
+        }
+
+        //rows [first, last) of a, b, c, d; a[i - 1] belongs to row i
+        auto load = [&](buffer &buf, std::size_t k)
+        {
+            std::size_t first = k * chunk, last = std::min(n, first + chunk);
+            std::size_t a_first = first > 0 ? first - 1 : 0, c_last = std::min(last, n - 1);
+            return read(buf.in, off_a + a_first * sizeof(T), buf.a.data(), last - 1 - a_first)
+                   && read(buf.in, off_b + first * sizeof(T), buf.b.data(), last - first)
+                   && read(buf.in, off_c + first * sizeof(T), buf.c.data(), c_last > first ? c_last - first : 0)
+                   && read(buf.in, off_d + first * sizeof(T), buf.d.data(), last - first);
+        };
+
+        std::fstream scratch(scratch_path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+        if (!scratch.is_open())
+            return false;
+        std::vector<T> pairs(2 * chunk);
+
+        //forward iteration, scratch holds (L[i], M[i]) for every row
+        T L_prev = 0, M_prev = 0;
+        auto pending = std::async(std::launch::async, load, std::ref(buffers[0]), 0);
+        for (std::size_t k = 0; k < chunks; k++)
+        {
+            if (!pending.get())
+                return false;
+            auto &buf = buffers[k % 2];
+            if (k + 1 < chunks)
+                pending = std::async(std::launch::async, load, std::ref(buffers[(k + 1) % 2]), k + 1);
+
+            std::size_t first = k * chunk, last = std::min(n, first + chunk);
+            for (std::size_t i = first; i < last; i++)
+            {
+                std::size_t j = i - first;
+                T a = i > 0 ? buf.a[first > 0 ? j : j - 1] : 0;
+                T denom = buf.b[j] - a * L_prev;
+                L_prev = i < n - 1 ? buf.c[j] / denom : 0;
+                M_prev = (buf.d[j] - a * M_prev) / denom;
+                pairs[2 * j] = L_prev;
+                pairs[2 * j + 1] = M_prev;
+            }
+            scratch.write(reinterpret_cast<const char *>(pairs.data()), 2 * (last - first) * sizeof(T));
+        }
+        if (!scratch.good())
+            return false;
+
+        //backward iteration, chunks in reverse order
+        std::ofstream out(solution_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+        std::array<std::vector<T>, 2> scratch_buffers = { std::vector<T>(2 * chunk), std::vector<T>(2 * chunk) };
+        std::vector<T> x(chunk);
+        auto load_pairs = [&](std::vector<T> &dst, std::size_t k)
+        {
+            std::size_t first = k * chunk, last = std::min(n, first + chunk);
+            scratch.seekg(2 * first * sizeof(T));
+            scratch.read(reinterpret_cast<char *>(dst.data()), 2 * (last - first) * sizeof(T));
+            return scratch.good();
+        };
+
+        T x_next = 0;
+        auto pending_pairs = std::async(std::launch::async, load_pairs, std::ref(scratch_buffers[0]), chunks - 1);
+        for (std::size_t k = chunks; k-- > 0;)
+        {
+            if (!pending_pairs.get())
+                return false;
+            auto &cur = scratch_buffers[(chunks - 1 - k) % 2];
+            if (k > 0)
+                pending_pairs = std::async(std::launch::async, load_pairs, std::ref(scratch_buffers[(chunks - k) % 2]), k - 1);
+
+            std::size_t first = k * chunk, last = std::min(n, first + chunk);
+            for (std::size_t i = last; i-- > first;)
+            {
+                std::size_t j = i - first;
+                x_next = cur[2 * j + 1] - cur[2 * j] * x_next;
+                x[j] = x_next;
+            }
+            out.seekp(first * sizeof(T));
+            out.write(reinterpret_cast<const char *>(x.data()), (last - first) * sizeof(T));
+        }
+
+        return out.good();
+    }
+}
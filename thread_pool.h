@@ -0,0 +1,98 @@
+#pragma once
+
+#include <thread>
+#include <future>
+#include <queue>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+
+//class decl (forward)
+namespace num
+{
+    class thread_pool;
+}
+
+//class def
+namespace num
+{
+    //fixed set of workers taking tasks from a shared FIFO queue
+    class thread_pool
+    {
+        std::vector<std::jthread> _workers;
+        std::queue<std::function<void()>> _tasks;
+        std::mutex _mutex;
+        std::condition_variable _ready;
+        bool _stop = false;
+
+        void work();
+
+    public:
+        explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency());
+        thread_pool(const thread_pool &other) = delete;
+        thread_pool &operator=(const thread_pool &other) = delete;
+        ~thread_pool();
+
+        std::size_t size() const;
+
+        template<typename F>
+        std::future<std::invoke_result_t<F>> submit(F &&func);
+    };
+}
+
+//func def
+namespace num
+{
+    inline thread_pool::thread_pool(std::size_t threads)
+    {
+        threads = std::max<std::size_t>(threads, 1);
+        for (std::size_t t = 0; t < threads; t++)
+            _workers.emplace_back([this]() { work(); });
+    }
+
+    inline thread_pool::~thread_pool()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _ready.notify_all();
+        _workers.clear();
+    }
+
+    inline void thread_pool::work()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(_mutex);
+                _ready.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+                if (_tasks.empty())
+                    return;
+                task = std::move(_tasks.front());
+                _tasks.pop();
+            }
+            task();
+        }
+    }
+
+    inline std::size_t thread_pool::size() const
+    {
+        return _workers.size();
+    }
+
+    template<typename F>
+    std::future<std::invoke_result_t<F>> thread_pool::submit(F &&func)
+    {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(func));
+        auto res = task->get_future();
+        {
+            std::lock_guard lock(_mutex);
+            _tasks.emplace([task]() { (*task)(); });
+        }
+        _ready.notify_one();
+        return res;
+    }
+}
@@ -7,6 +7,8 @@ namespace num
 {
     template<std::floating_point T>
     class tridiag;
+    template<std::floating_point T>
+    struct residual_norms;
 
     template<std::floating_point T>
     bool operator==(const tridiag<T> &lhs, const tridiag<T> &rhs);
@@ -27,6 +29,9 @@ namespace num
     template<std::floating_point T>
     vector<T> operator*(const tridiag<T> &mat, const vector<T> &vec);
 
+    template<std::floating_point T>
+    residual_norms<T> residual(const tridiag<T> &mat, const vector<T> &x, const vector<T> &vec);
+
     template<std::floating_point T>
     std::ostream &operator<<(std::ostream &out, const tridiag<T> &mat);
     template<std::floating_point T>
@@ -42,18 +47,26 @@ namespace num
     public:
         vector<T> a, b, c;
 
-        tridiag(std::size_t size = 1, const T &value = 0);
-        tridiag(const vector<T> &a,
-                const vector<T> &b,
-                const vector<T> &c);
+        tridiag(std::size_t size = 1, const T &value = 0, std::pmr::memory_resource *resource = default_resource());
+        tridiag(vector<T> a,
+                vector<T> b,
+                vector<T> c);
         tridiag(std::size_t size, const T &min, const T &max);
         tridiag(std::size_t size,
                 const T &min_a, const T &max_a,
                 const T &min_b, const T &max_b,
                 const T &min_c, const T &max_c);
+        tridiag(std::size_t size,
+                const T &min_a, const T &max_a,
+                const T &min_b, const T &max_b,
+                const T &min_c, const T &max_c,
+                const random_key &key,
+                std::pmr::memory_resource *resource = default_resource());
 
         tridiag(const tridiag &other);
+        tridiag(tridiag &&other) noexcept;
         tridiag &operator=(const tridiag &other);
+        tridiag &operator=(tridiag &&other);     //may copy, see vector
 
         std::size_t size() const;
 
@@ -70,42 +83,64 @@ namespace num
         friend std::ostream &operator<<<T>(std::ostream &out, const tridiag &mat);
         friend std::istream &operator>><T>(std::istream &in, tridiag &mat);
     };
+
+    //norms of A * x - vec
+    template<std::floating_point T>
+    struct residual_norms
+    {
+        T inf, two;
+    };
 }
 
 //func def
 namespace num
 {
     template<std::floating_point T>
-    tridiag<T>::tridiag(std::size_t size, const T &value)
-        : a(size - 1, value, 2), b(size, value), c(size - 1, value) {}
+    tridiag<T>::tridiag(std::size_t size, const T &value, std::pmr::memory_resource *resource)
+        : a(size > 0 ? size - 1 : 0, value, 2, resource), b(size, value, 1, resource),
+          c(size > 0 ? size - 1 : 0, value, 1, resource) {}
 
     template<std::floating_point T>
-    tridiag<T>::tridiag(const vector<T> &a,
-                        const vector<T> &b,
-                        const vector<T> &c)
-        : a(a, 2), b(b), c(c) {}
+    tridiag<T>::tridiag(vector<T> a,
+                        vector<T> b,
+                        vector<T> c)
+        : a(std::move(a)), b(std::move(b)), c(std::move(c))
+    {
+        this->a.indexing = 2;
+    }
 
     template<std::floating_point T>
     tridiag<T>::tridiag(std::size_t size, const T &min, const T &max)
-        : a(size - 1, min, max, 2),
-          b(size, min, max),
-          c(size - 1, min, max)
-          {}
+        : tridiag(size, min, max, min, max, min, max) {}
 
     template<std::floating_point T>
     tridiag<T>::tridiag(std::size_t size,
                         const T &min_a, const T &max_a,
                         const T &min_b, const T &max_b,
                         const T &min_c, const T &max_c)
-        : a(size - 1, min_a, max_a, 2),
-          b(size, min_b, max_b),
-          c(size - 1, min_c, max_c)
+        : tridiag(size, min_a, max_a, min_b, max_b, min_c, max_c, random_key{ std::random_device()() }) {}
+
+    //a, b, c use streams key.stream, key.stream + 1, key.stream + 2
+    template<std::floating_point T>
+    tridiag<T>::tridiag(std::size_t size,
+                        const T &min_a, const T &max_a,
+                        const T &min_b, const T &max_b,
+                        const T &min_c, const T &max_c,
+                        const random_key &key,
+                        std::pmr::memory_resource *resource)
+        : a(size > 0 ? size - 1 : 0, min_a, max_a, key, 2, resource),
+          b(size, min_b, max_b, random_key{ key.seed, key.stream + 1 }, 1, resource),
+          c(size > 0 ? size - 1 : 0, min_c, max_c, random_key{ key.seed, key.stream + 2 }, 1, resource)
           {}
 
     template<std::floating_point T>
     tridiag<T>::tridiag(const tridiag &other)
             : a(other.a), b(other.b), c(other.c) {}
 
+    template<std::floating_point T>
+    tridiag<T>::tridiag(tridiag &&other) noexcept
+            : a(std::move(other.a)), b(std::move(other.b)), c(std::move(other.c)) {}
+
     template<std::floating_point T>
     tridiag<T> &tridiag<T>::operator=(const tridiag<T> &other)
     {
@@ -115,6 +150,15 @@ namespace num
         return *this;
     }
 
+    template<std::floating_point T>
+    tridiag<T> &tridiag<T>::operator=(tridiag<T> &&other)
+    {
+        a = std::move(other.a);
+        b = std::move(other.b);
+        c = std::move(other.c);
+        return *this;
+    }
+
     template<std::floating_point T>
     std::size_t tridiag<T>::size() const
     {
@@ -166,23 +210,41 @@ namespace num
     template<std::floating_point T>
     vector<T> operator*(const tridiag<T> &mat, const vector<T> &vec)
     {
-        int n = mat.size();
+        std::size_t n = mat.size();
         vector<T> res(n);
-        res[1] = mat.b[1] * vec[1] + mat.c[1] * vec[2];
-        for (int i = 2; i < n; i++)
-            res[i] = mat.a[i] * vec[i - 1] + mat.b[i] * vec[i] + mat.c[i] * vec[i + 1];
-        res[n] = mat.a[n] * vec[n - 1] + mat.b[n] * vec[n];
+        simd::matvec(mat.a.data(), mat.b.data(), mat.c.data(), vec.data(), res.data(), n);
         return res;
     }
 
+    //fused into one pass over the diagonals, A * x - vec is never stored
+    template<std::floating_point T>
+    residual_norms<T> residual(const tridiag<T> &mat, const vector<T> &x, const vector<T> &vec)
+    {
+        T max, two;
+        simd::residual(mat.a.data(), mat.b.data(), mat.c.data(), x.data(), vec.data(), mat.size(), max, two);
+        return { max, two };
+    }
+
+    //n x n with zeros only in dense mode, see print_mode
     template<std::floating_point T>
     std::ostream &operator<<(std::ostream &out, const tridiag<T> &mat)
     {
-        int n = mat.size();
+        std::size_t n = mat.size();
+        auto mode = print_mode_of(out, n, true);
+        if (mode != print_mode::dense)
+        {
+            //empty matrix: empty diagonals rather than n - 1 wrapping around
+            std::size_t off = n > 0 ? n - 1 : 0;
+            print_diagonal(out, "a", mat.a.data(), off, mode);
+            print_diagonal(out, "b", mat.b.data(), n, mode);
+            print_diagonal(out, "c", mat.c.data(), off, mode);
+            return out;
+        }
+
         int places = format<T>(out);
-        for (int i = 1; i <= n; i++)
+        for (std::size_t i = 1; i <= n; i++)
         {
-            for (int j = 1; j <= n; j++)
+            for (std::size_t j = 1; j <= n; j++)
             {
                 if (j == i + 1)
                     out << std::setw(places) << mat.c[i];
@@ -4,12 +4,29 @@
 #include <random>
 #include <algorithm>
 #include <functional>
+#include <cmath>
+#include <limits>
 
 #include "format.h"
+#include "random.h"
+#include "memory.h"
+#include "simd.h"
 
 //class / func decl (forward)
 namespace num
 {
+    template<typename E>
+    class vector_expr;
+
+    template<typename E, typename Op>
+    class vector_unary;
+
+    template<typename L, typename R, typename Op>
+    class vector_binary;
+
+    template<typename E, typename Op>
+    class vector_scalar;
+
     template<std::floating_point T>
     class vector;
 
@@ -18,19 +35,27 @@ namespace num
     template<std::floating_point T>
     bool operator!=(const vector<T> &lhs, const vector<T> &rhs);
 
+    template<typename E>
+    vector_unary<E, std::negate<>> operator-(const vector_expr<E> &vec);
+    template<typename L, typename R>
+    vector_binary<L, R, std::plus<>> operator+(const vector_expr<L> &lhs, const vector_expr<R> &rhs);
+    template<typename L, typename R>
+    vector_binary<L, R, std::minus<>> operator-(const vector_expr<L> &lhs, const vector_expr<R> &rhs);
+
+    template<typename E>
+    vector_scalar<E, std::multiplies<>> operator*(const vector_expr<E> &vec, const typename E::value_type &scalar);
+    template<typename E>
+    vector_scalar<E, std::multiplies<>> operator*(const typename E::value_type &scalar, const vector_expr<E> &vec);
+    template<typename L, typename R>
+    typename L::value_type operator*(const vector_expr<L> &lhs, const vector_expr<R> &rhs);
     template<std::floating_point T>
-    vector<T> operator-(const vector<T> &vec);
-    template<std::floating_point T>
-    vector<T> operator+(const vector<T> &lhs, const vector<T> &rhs);
-    template<std::floating_point T>
-    vector<T> operator-(const vector<T> &lhs, const vector<T> &rhs);
+    T operator*(const vector<T> &lhs, const vector<T> &rhs);
 
     template<std::floating_point T>
-    vector<T> operator*(const vector<T> &vec, const T &scalar);
-    template<std::floating_point T>
-    vector<T> operator*(const T &scalar, const vector<T> &vec);
+    void axpy(const T &alpha, const vector<T> &x, vector<T> &y);
+
     template<std::floating_point T>
-    T operator*(const vector<T> &lhs, const vector<T> &rhs);
+    constexpr T nan_max(T lhs, T rhs);
 
     template<std::floating_point T>
     std::ostream &operator<<(std::ostream &out, const vector<T> &vec);
@@ -41,37 +66,109 @@ namespace num
 //class def
 namespace num
 {
+    //base of vectors and lazy vector expressions: E provides value_type, size() and eval(i) (0-based),
+    //so a whole expression is computed in one loop when assigned or reduced
+    template<typename E>
+    class vector_expr
+    {
+    public:
+        const E &self() const;
+
+        auto len() const;
+        auto norm() const;
+    };
+
+    //operands are stored by reference for vectors and by value for nested expressions
+    template<typename E>
+    using expr_ref = std::conditional_t<requires { E::is_leaf; }, const E &, E>;
+
+    template<typename E, typename Op>
+    class vector_unary : public vector_expr<vector_unary<E, Op>>
+    {
+        expr_ref<E> _vec;
+
+    public:
+        using value_type = typename E::value_type;
+
+        vector_unary(const E &vec);
+
+        std::size_t size() const;
+        value_type eval(std::size_t i) const;
+    };
+
+    template<typename L, typename R, typename Op>
+    class vector_binary : public vector_expr<vector_binary<L, R, Op>>
+    {
+        expr_ref<L> _lhs;
+        expr_ref<R> _rhs;
+
+    public:
+        using value_type = typename L::value_type;
+
+        vector_binary(const L &lhs, const R &rhs);
+
+        std::size_t size() const;
+        value_type eval(std::size_t i) const;
+    };
+
+    template<typename E, typename Op>
+    class vector_scalar : public vector_expr<vector_scalar<E, Op>>
+    {
+        expr_ref<E> _vec;
+        typename E::value_type _scalar;
+
+    public:
+        using value_type = typename E::value_type;
+
+        vector_scalar(const E &vec, const value_type &scalar);
+
+        std::size_t size() const;
+        value_type eval(std::size_t i) const;
+    };
+
     template<std::floating_point T>
-    class vector
+    class vector : public vector_expr<vector<T>>
     {
-        std::vector<T> _values;
+        std::pmr::vector<T> _values;
 
     public:
+        using value_type = T;
+        static constexpr bool is_leaf = true;
+
         int indexing = 1;
 
-        vector(std::size_t size = 1, const T &value = 0, int indexing = 1);
+        vector(std::size_t size = 1, const T &value = 0, int indexing = 1,
+               std::pmr::memory_resource *resource = default_resource());
         vector(std::size_t size, const T &min, const T &max, int indexing = 1);
+        vector(std::size_t size, const T &min, const T &max, const random_key &key, int indexing = 1,
+               std::pmr::memory_resource *resource = default_resource());
+        template<typename E>
+        vector(const vector_expr<E> &expr, int indexing = 1, std::pmr::memory_resource *resource = default_resource());
 
+        //copies use the default resource, moves keep the source's one; assignment keeps the target's
+        //resource as std::pmr does, so move assignment between different resources copies and may throw
         vector(const vector &other);
+        vector(vector &&other) noexcept;
         vector &operator=(const vector &other);
+        vector &operator=(vector &&other);
+        template<typename E>
+        vector &operator=(const vector_expr<E> &expr);
 
         T &operator[](std::size_t pos);
         const T &operator[](std::size_t pos) const;
 
+        T *data();
+        const T *data() const;
+
         std::size_t size() const;
+        std::pmr::memory_resource *resource() const;
+        T eval(std::size_t i) const;
         T len() const;
         T norm() const;
 
         friend bool operator==<T>(const vector &lhs, const vector &rhs);
         friend bool operator!=<T>(const vector &lhs, const vector &rhs);
 
-        friend vector operator-<T>(const vector &vec);
-        friend vector operator+<T>(const vector &lhs, const vector &rhs);
-        friend vector operator-<T>(const vector &lhs, const vector &rhs);
-
-        friend vector operator*<T>(const vector &vec, const T &scalar);
-        friend T operator*<T>(const vector &lhs, const vector &rhs);
-
         friend std::ostream &operator<<<T>(std::ostream &out, const vector &vec);
         friend std::istream &operator>><T>(std::istream &in, vector &vec);
     };
@@ -80,26 +177,119 @@ namespace num
 //func def
 namespace num
 {
-    template<std::floating_point T>
-    vector<T>::vector(std::size_t size, const T &value, int indexing)
-        : _values(size), indexing(indexing)
+    template<typename E>
+    const E &vector_expr<E>::self() const
+    {
+        return static_cast<const E &>(*this);
+    }
+
+    template<typename E>
+    auto vector_expr<E>::len() const
+    {
+        typename E::value_type res = 0;
+        std::size_t n = self().size();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            auto val = self().eval(i);
+            res += val * val;
+        }
+        return std::sqrt(res);
+    }
+
+    template<typename E>
+    auto vector_expr<E>::norm() const
+    {
+        typename E::value_type res = 0;
+        std::size_t n = self().size();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            auto val = std::abs(self().eval(i));
+            if (std::isnan(val))
+                return val;
+            res = std::max(res, val);
+        }
+        return res;
+    }
+
+    template<typename E, typename Op>
+    vector_unary<E, Op>::vector_unary(const E &vec)
+        : _vec(vec) {}
+
+    template<typename E, typename Op>
+    std::size_t vector_unary<E, Op>::size() const
+    {
+        return _vec.size();
+    }
+
+    template<typename E, typename Op>
+    typename vector_unary<E, Op>::value_type vector_unary<E, Op>::eval(std::size_t i) const
+    {
+        return Op()(_vec.eval(i));
+    }
+
+    template<typename L, typename R, typename Op>
+    vector_binary<L, R, Op>::vector_binary(const L &lhs, const R &rhs)
+        : _lhs(lhs), _rhs(rhs) {}
+
+    template<typename L, typename R, typename Op>
+    std::size_t vector_binary<L, R, Op>::size() const
     {
-        std::ranges::fill(_values, value);
+        return _lhs.size();
+    }
+
+    template<typename L, typename R, typename Op>
+    typename vector_binary<L, R, Op>::value_type vector_binary<L, R, Op>::eval(std::size_t i) const
+    {
+        return Op()(_lhs.eval(i), _rhs.eval(i));
+    }
+
+    template<typename E, typename Op>
+    vector_scalar<E, Op>::vector_scalar(const E &vec, const value_type &scalar)
+        : _vec(vec), _scalar(scalar) {}
+
+    template<typename E, typename Op>
+    std::size_t vector_scalar<E, Op>::size() const
+    {
+        return _vec.size();
+    }
+
+    template<typename E, typename Op>
+    typename vector_scalar<E, Op>::value_type vector_scalar<E, Op>::eval(std::size_t i) const
+    {
+        return Op()(_vec.eval(i), _scalar);
     }
 
+    template<std::floating_point T>
+    vector<T>::vector(std::size_t size, const T &value, int indexing, std::pmr::memory_resource *resource)
+        : _values(size, value, resource), indexing(indexing) {}
+
     template<std::floating_point T>
     vector<T>::vector(std::size_t size, const T &min, const T &max, int indexing)
-        : _values(size), indexing(indexing)
+        : vector(size, min, max, random_key{ std::random_device()() }, indexing) {}
+
+    template<std::floating_point T>
+    vector<T>::vector(std::size_t size, const T &min, const T &max, const random_key &key, int indexing,
+                      std::pmr::memory_resource *resource)
+        : _values(size, resource), indexing(indexing)
+    {
+        fill_uniform(_values.data(), size, min, max, key);
+    }
+
+    template<std::floating_point T>
+    template<typename E>
+    vector<T>::vector(const vector_expr<E> &expr, int indexing, std::pmr::memory_resource *resource)
+        : _values(expr.self().size(), resource), indexing(indexing)
     {
-        std::mt19937 rng((std::random_device()()));
-        std::uniform_real_distribution<T> distrib(min, max);
-        std::ranges::generate(_values,
-                              [&rng, &distrib]() { return distrib(rng); });
+        *this = expr;
     }
 
     template<std::floating_point T>
     vector<T>::vector(const vector<T> &other)
-            : _values(other._values), indexing(other.indexing) {}
+            : _values(other._values, default_resource()), indexing(other.indexing) {}
+
+    template<std::floating_point T>
+    vector<T>::vector(vector<T> &&other) noexcept
+            : _values(std::move(other._values)), indexing(other.indexing) {}
 
     template<std::floating_point T>
     vector<T> &vector<T>::operator=(const vector<T> &other)
@@ -109,7 +299,29 @@ namespace num
     }
 
     template<std::floating_point T>
-    T &vector<T>::operator[](std::size_t pos) 
+    vector<T> &vector<T>::operator=(vector<T> &&other)
+    {
+        if (_values.get_allocator() == other._values.get_allocator())
+            _values.swap(other._values);
+        else
+            _values = other._values;
+        return *this;
+    }
+
+    template<std::floating_point T>
+    template<typename E>
+    vector<T> &vector<T>::operator=(const vector_expr<E> &expr)
+    {
+        auto& e = expr.self();
+        std::size_t n = e.size();
+        _values.resize(n);
+        for (std::size_t i = 0; i < n; i++)
+            _values[i] = e.eval(i);
+        return *this;
+    }
+
+    template<std::floating_point T>
+    T &vector<T>::operator[](std::size_t pos)
     {
         return _values[pos - indexing];
     }
@@ -120,12 +332,36 @@ namespace num
         return _values[pos - indexing];
     }
 
+    template<std::floating_point T>
+    T *vector<T>::data()
+    {
+        return _values.data();
+    }
+
+    template<std::floating_point T>
+    const T *vector<T>::data() const
+    {
+        return _values.data();
+    }
+
     template<std::floating_point T>
     std::size_t vector<T>::size() const
     {
         return _values.size();
     }
 
+    template<std::floating_point T>
+    std::pmr::memory_resource *vector<T>::resource() const
+    {
+        return _values.get_allocator().resource();
+    }
+
+    template<std::floating_point T>
+    T vector<T>::eval(std::size_t i) const
+    {
+        return _values[i];
+    }
+
     template<std::floating_point T>
     T vector<T>::len() const
     {
@@ -135,8 +371,7 @@ namespace num
     template<std::floating_point T>
     T vector<T>::norm() const
     {
-        return std::abs(*std::ranges::max_element(_values,
-                                                  [](const auto& lhs, const auto& rhs) { return std::abs(lhs) < std::abs(rhs); }));
+        return simd::max_abs(_values.data(), _values.size());
     }
 
     template<std::floating_point T>
@@ -151,60 +386,71 @@ namespace num
         return !(lhs == rhs);
     }
 
-    template<std::floating_point T>
-    vector<T> operator-(const vector<T> &vec)
+    template<typename E>
+    vector_unary<E, std::negate<>> operator-(const vector_expr<E> &vec)
     {
-        vector<T> res(vec.size());
-        std::ranges::transform(vec._values, res._values.begin(), std::negate());
-        return res;
+        return vector_unary<E, std::negate<>>(vec.self());
     }
 
-    template<std::floating_point T>
-    vector<T> operator+(const vector<T> &lhs, const vector<T> &rhs)
+    template<typename L, typename R>
+    vector_binary<L, R, std::plus<>> operator+(const vector_expr<L> &lhs, const vector_expr<R> &rhs)
     {
-        vector<T> res(lhs.size());
-        std::ranges::transform(lhs._values, rhs._values, res._values.begin(), std::plus());
-        return res;
+        return vector_binary<L, R, std::plus<>>(lhs.self(), rhs.self());
     }
 
-    template<std::floating_point T>
-    vector<T> operator-(const vector<T> &lhs, const vector<T> &rhs)
+    template<typename L, typename R>
+    vector_binary<L, R, std::minus<>> operator-(const vector_expr<L> &lhs, const vector_expr<R> &rhs)
+    {
+        return vector_binary<L, R, std::minus<>>(lhs.self(), rhs.self());
+    }
+
+    template<typename E>
+    vector_scalar<E, std::multiplies<>> operator*(const vector_expr<E> &vec, const typename E::value_type &scalar)
+    {
+        return vector_scalar<E, std::multiplies<>>(vec.self(), scalar);
+    }
+
+    template<typename E>
+    vector_scalar<E, std::multiplies<>> operator*(const typename E::value_type &scalar, const vector_expr<E> &vec)
+    {
+        return vec * scalar;
+    }
+
+    template<typename L, typename R>
+    typename L::value_type operator*(const vector_expr<L> &lhs, const vector_expr<R> &rhs)
     {
-        vector<T> res(lhs.size());
-        std::ranges::transform(lhs._values, rhs._values, res._values.begin(), std::minus());
+        typename L::value_type res = 0;
+        std::size_t n = lhs.self().size();
+        for (std::size_t i = 0; i < n; i++)
+            res += lhs.self().eval(i) * rhs.self().eval(i);
         return res;
     }
 
     template<std::floating_point T>
-    vector<T> operator*(const vector<T> &vec, const T &scalar)
+    T operator*(const vector<T> &lhs, const vector<T> &rhs)
     {
-        vector<T> res(vec.size());
-        std::ranges::transform(vec._values, res._values.begin(),
-                               [&scalar](const auto& val) { return val * scalar; });
-        return res;
+        return simd::dot(lhs.data(), rhs.data(), lhs.size());
     }
 
+    //y += alpha * x
     template<std::floating_point T>
-    vector<T> operator*(const T &scalar, const vector<T> &vec)
+    void axpy(const T &alpha, const vector<T> &x, vector<T> &y)
     {
-        return vec * scalar;
+        simd::axpy(alpha, x.data(), y.data(), y.size());
     }
 
+    //maximum that keeps NaN as norm does, so aggregates over trials do not hide a diverged one
+    //(x != x is isnan, usable in constexpr)
     template<std::floating_point T>
-    T operator*(const vector<T> &lhs, const vector<T> &rhs)
+    constexpr T nan_max(T lhs, T rhs)
     {
-        T res = 0;
-        int n = lhs.size();
-        for (int i = 0; i < n; i++)
-            res += lhs._values[i] * rhs._values[i];
-        return res;
+        return lhs != lhs || rhs != rhs ? std::numeric_limits<T>::quiet_NaN() : std::max(lhs, rhs);
     }
 
     template<std::floating_point T>
     std::ostream &operator<<(std::ostream &out, const vector<T> &vec)
     {
-        int places = format<T>(out);
-        std::ranges::for_each(vec._values, [&out, &places](const auto& val) { out << std::setw(places) << val; });
+        print_values(out, vec._values.data(), vec.size(), 1, print_mode_of(out, vec.size(), false));
         return out << std::endl;
     }
 
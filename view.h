@@ -0,0 +1,353 @@
+#pragma once
+
+#include <span>
+#include <type_traits>
+
+#include "tridiag.h"
+#include "multivector.h"
+#include "solve.h"
+
+//class / func decl (forward)
+namespace num
+{
+    template<std::floating_point T>
+    class vector_view;
+    template<std::floating_point T>
+    class tridiag_view;
+    template<std::floating_point T>
+    class multivector_view;
+
+    template<std::floating_point T>
+    vector<T> operator*(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec);
+
+    template<std::floating_point T>
+    std::ostream &operator<<(std::ostream &out, const vector_view<T> &vec);
+
+    template<std::floating_point T>
+    vector<T> thomas_alg(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec);
+    template<std::floating_point T>
+    void thomas_alg(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec,
+                    std::type_identity_t<vector_view<T>> x, workspace<T> &ws);
+
+    template<std::floating_point T>
+    vector<T> unstable_method(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec);
+    template<std::floating_point T>
+    void unstable_method(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec,
+                         std::type_identity_t<vector_view<T>> x, workspace<T> &ws);
+}
+
+//class def
+namespace num
+{
+    //non-owning strided view of size values, element pos is data[(pos - indexing) * stride];
+    //T may be const for read-only memory. Copying a view copies the reference, assign() writes values
+    template<std::floating_point T>
+    class vector_view : public vector_expr<vector_view<T>>
+    {
+        T *_data;
+        std::size_t _size;
+        std::ptrdiff_t _stride;
+
+    public:
+        using value_type = std::remove_const_t<T>;
+        static constexpr bool is_leaf = true;
+
+        int indexing = 1;
+
+        vector_view(T *data, std::size_t size, std::ptrdiff_t stride = 1, int indexing = 1);
+        vector_view(std::span<T> values, int indexing = 1);
+        vector_view(vector<value_type> &vec) requires (!std::is_const_v<T>);
+        vector_view(const vector<value_type> &vec) requires std::is_const_v<T>;
+        template<typename U>
+        requires std::same_as<const U, T> && (!std::same_as<U, T>)
+        vector_view(const vector_view<U> &other);
+
+        template<typename E>
+        const vector_view &assign(const vector_expr<E> &expr) const;
+
+        T &operator[](std::size_t pos) const;
+
+        T *data() const;
+        std::size_t size() const;
+        std::ptrdiff_t stride() const;
+        value_type eval(std::size_t i) const;
+
+        //same elements indexed from 0, as expected by solver sweeps
+        vector_view base() const;
+    };
+
+    //read-only view of tridiag coefficients in foreign memory, same 1-based layout as tridiag: a from 2
+    template<std::floating_point T>
+    class tridiag_view
+    {
+    public:
+        vector_view<const T> a, b, c;
+
+        tridiag_view(vector_view<const T> a,
+                     vector_view<const T> b,
+                     vector_view<const T> c);
+        tridiag_view(const tridiag<T> &mat);
+
+        std::size_t size() const;
+
+        //owning copy, for code that has no view overload
+        explicit operator tridiag<T>() const;
+    };
+
+    //non-owning view of count interleaved vectors of size values as in multivector:
+    //row pos starts at data + (pos - indexing) * row_stride and holds component pos of every vector
+    template<std::floating_point T>
+    class multivector_view
+    {
+        T *_data;
+        std::size_t _size, _count;
+        std::ptrdiff_t _row_stride;
+
+    public:
+        using value_type = std::remove_const_t<T>;
+
+        int indexing = 1;
+
+        multivector_view(T *data, std::size_t size, std::size_t count, std::ptrdiff_t row_stride, int indexing = 1);
+        multivector_view(multivector<value_type> &vecs) requires (!std::is_const_v<T>);
+        multivector_view(const multivector<value_type> &vecs) requires std::is_const_v<T>;
+        template<typename U>
+        requires std::same_as<const U, T> && (!std::same_as<U, T>)
+        multivector_view(const multivector_view<U> &other);
+
+        T *operator[](std::size_t pos) const;
+
+        std::size_t size() const;
+        std::size_t count() const;
+        std::ptrdiff_t row_stride() const;
+    };
+}
+
+//func def
+namespace num
+{
+    template<std::floating_point T>
+    vector_view<T>::vector_view(T *data, std::size_t size, std::ptrdiff_t stride, int indexing)
+        : _data(data), _size(size), _stride(stride), indexing(indexing) {}
+
+    template<std::floating_point T>
+    vector_view<T>::vector_view(std::span<T> values, int indexing)
+        : vector_view(values.data(), values.size(), 1, indexing) {}
+
+    template<std::floating_point T>
+    vector_view<T>::vector_view(vector<value_type> &vec) requires (!std::is_const_v<T>)
+        : vector_view(vec.data(), vec.size(), 1, vec.indexing) {}
+
+    template<std::floating_point T>
+    vector_view<T>::vector_view(const vector<value_type> &vec) requires std::is_const_v<T>
+        : vector_view(vec.data(), vec.size(), 1, vec.indexing) {}
+
+    template<std::floating_point T>
+    template<typename U>
+    requires std::same_as<const U, T> && (!std::same_as<U, T>)
+    vector_view<T>::vector_view(const vector_view<U> &other)
+        : vector_view(other.data(), other.size(), other.stride(), other.indexing) {}
+
+    template<std::floating_point T>
+    template<typename E>
+    const vector_view<T> &vector_view<T>::assign(const vector_expr<E> &expr) const
+    {
+        auto &e = expr.self();
+        for (std::size_t i = 0; i < _size; i++)
+            _data[i * _stride] = e.eval(i);
+        return *this;
+    }
+
+    template<std::floating_point T>
+    T &vector_view<T>::operator[](std::size_t pos) const
+    {
+        return _data[std::ptrdiff_t(pos - indexing) * _stride];
+    }
+
+    template<std::floating_point T>
+    T *vector_view<T>::data() const
+    {
+        return _data;
+    }
+
+    template<std::floating_point T>
+    std::size_t vector_view<T>::size() const
+    {
+        return _size;
+    }
+
+    template<std::floating_point T>
+    std::ptrdiff_t vector_view<T>::stride() const
+    {
+        return _stride;
+    }
+
+    template<std::floating_point T>
+    typename vector_view<T>::value_type vector_view<T>::eval(std::size_t i) const
+    {
+        return _data[std::ptrdiff_t(i) * _stride];
+    }
+
+    template<std::floating_point T>
+    vector_view<T> vector_view<T>::base() const
+    {
+        return vector_view(_data, _size, _stride, 0);
+    }
+
+    template<std::floating_point T>
+    tridiag_view<T>::tridiag_view(vector_view<const T> a,
+                                  vector_view<const T> b,
+                                  vector_view<const T> c)
+        : a(a), b(b), c(c)
+    {
+        this->a.indexing = 2;
+    }
+
+    template<std::floating_point T>
+    tridiag_view<T>::tridiag_view(const tridiag<T> &mat)
+        : tridiag_view(mat.a, mat.b, mat.c) {}
+
+    template<std::floating_point T>
+    std::size_t tridiag_view<T>::size() const
+    {
+        return b.size();
+    }
+
+    template<std::floating_point T>
+    tridiag_view<T>::operator tridiag<T>() const
+    {
+        return tridiag<T>(vector<T>(a), vector<T>(b), vector<T>(c));
+    }
+
+    template<std::floating_point T>
+    multivector_view<T>::multivector_view(T *data, std::size_t size, std::size_t count, std::ptrdiff_t row_stride,
+                                          int indexing)
+        : _data(data), _size(size), _count(count), _row_stride(row_stride), indexing(indexing) {}
+
+    template<std::floating_point T>
+    multivector_view<T>::multivector_view(multivector<value_type> &vecs) requires (!std::is_const_v<T>)
+        : multivector_view(vecs[vecs.indexing], vecs.size(), vecs.count(), vecs.count(), vecs.indexing) {}
+
+    template<std::floating_point T>
+    multivector_view<T>::multivector_view(const multivector<value_type> &vecs) requires std::is_const_v<T>
+        : multivector_view(vecs[vecs.indexing], vecs.size(), vecs.count(), vecs.count(), vecs.indexing) {}
+
+    template<std::floating_point T>
+    template<typename U>
+    requires std::same_as<const U, T> && (!std::same_as<U, T>)
+    multivector_view<T>::multivector_view(const multivector_view<U> &other)
+        : multivector_view(other[other.indexing], other.size(), other.count(), other.row_stride(), other.indexing) {}
+
+    template<std::floating_point T>
+    T *multivector_view<T>::operator[](std::size_t pos) const
+    {
+        return _data + std::ptrdiff_t(pos - indexing) * _row_stride;
+    }
+
+    template<std::floating_point T>
+    std::size_t multivector_view<T>::size() const
+    {
+        return _size;
+    }
+
+    template<std::floating_point T>
+    std::size_t multivector_view<T>::count() const
+    {
+        return _count;
+    }
+
+    template<std::floating_point T>
+    std::ptrdiff_t multivector_view<T>::row_stride() const
+    {
+        return _row_stride;
+    }
+
+    namespace view_detail
+    {
+        //func(a, b, c, d) with 0-based accessors of row i of the system, a(0) = c(n - 1) = 0;
+        //contiguous views are read through plain pointers so that loops over them vectorize
+        template<std::floating_point T, typename F>
+        decltype(auto) rows(const tridiag_view<T> &mat, const vector_view<const T> &vec, F &&func)
+        {
+            std::size_t n = mat.size();
+            if (mat.a.stride() == 1 && mat.b.stride() == 1 && mat.c.stride() == 1 && vec.stride() == 1)
+            {
+                const T *a = mat.a.data(), *b = mat.b.data(), *c = mat.c.data(), *d = vec.data();
+                return func([a](std::size_t i) { return i > 0 ? a[i - 1] : T(0); },
+                            [b](std::size_t i) { return b[i]; },
+                            [c, n](std::size_t i) { return i < n - 1 ? c[i] : T(0); },
+                            [d](std::size_t i) { return d[i]; });
+            }
+            auto a = mat.a.base(), b = mat.b.base(), c = mat.c.base(), d = vec.base();
+            return func([a](std::size_t i) { return i > 0 ? a[i - 1] : T(0); },
+                        [b](std::size_t i) { return b[i]; },
+                        [c, n](std::size_t i) { return i < n - 1 ? c[i] : T(0); },
+                        [d](std::size_t i) { return d[i]; });
+        }
+    }
+
+    //contiguous operands go to simd::matvec, strided ones are multiplied row by row
+    template<std::floating_point T>
+    vector<T> operator*(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec)
+    {
+        std::size_t n = mat.size();
+        vector<T> res(n);
+        if (mat.a.stride() == 1 && mat.b.stride() == 1 && mat.c.stride() == 1 && vec.stride() == 1)
+        {
+            simd::matvec(mat.a.data(), mat.b.data(), mat.c.data(), vec.data(), res.data(), n);
+            return res;
+        }
+
+        auto a = mat.a.base(), b = mat.b.base(), c = mat.c.base(), x = vec.base();
+        T *r = res.data();
+        r[0] = b[0] * x[0] + (n > 1 ? c[0] * x[1] : 0);
+        for (std::size_t i = 1; i + 1 < n; i++)
+            r[i] = a[i - 1] * x[i - 1] + b[i] * x[i] + c[i] * x[i + 1];
+        if (n > 1)
+            r[n - 1] = a[n - 2] * x[n - 2] + b[n - 1] * x[n - 1];
+        return res;
+    }
+
+    template<std::floating_point T>
+    std::ostream &operator<<(std::ostream &out, const vector_view<T> &vec)
+    {
+        print_values(out, vec.data(), vec.size(), vec.stride(), print_mode_of(out, vec.size(), false));
+        return out << std::endl;
+    }
+
+    template<std::floating_point T>
+    vector<T> thomas_alg(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec)
+    {
+        vector<T> x(mat.size());
+        workspace<T> ws;
+        thomas_alg(mat, vec, x, ws);
+        return x;
+    }
+
+    //x may alias vec
+    template<std::floating_point T>
+    void thomas_alg(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec,
+                    std::type_identity_t<vector_view<T>> x, workspace<T> &ws)
+    {
+        auto base = x.base();
+        solve_detail::thomas(mat.a.base(), mat.b.base(), mat.c.base(), vec.base(), base, mat.size(), ws.reserve(mat.size()));
+    }
+
+    template<std::floating_point T>
+    vector<T> unstable_method(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec)
+    {
+        vector<T> x(mat.size());
+        workspace<T> ws;
+        unstable_method(mat, vec, x, ws);
+        return x;
+    }
+
+    //x may alias vec
+    template<std::floating_point T>
+    void unstable_method(const tridiag_view<T> &mat, std::type_identity_t<vector_view<const T>> vec,
+                         std::type_identity_t<vector_view<T>> x, workspace<T> &ws)
+    {
+        auto base = x.base();
+        solve_detail::unstable(mat.a.base(), mat.b.base(), mat.c.base(), vec.base(), base, mat.size(), ws.reserve(mat.size()));
+    }
+}
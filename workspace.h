@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <concepts>
+
+#include "memory.h"
+#include "stats.h"
+
+//class decl (forward)
+namespace num
+{
+    template<std::floating_point T>
+    class workspace;
+}
+
+//class def
+namespace num
+{
+    //reusable scratch memory for solvers: grows on demand and is never shrunk,
+    //so repeated solves of equal or smaller size do not allocate
+    template<std::floating_point T>
+    class workspace
+    {
+        std::pmr::vector<T> _values;
+
+    public:
+        workspace(std::size_t size = 0, std::pmr::memory_resource *resource = default_resource());
+
+        T *reserve(std::size_t size);
+        std::size_t capacity() const;
+    };
+}
+
+//func def
+namespace num
+{
+    template<std::floating_point T>
+    workspace<T>::workspace(std::size_t size, std::pmr::memory_resource *resource)
+        : _values(size, resource) {}
+
+    template<std::floating_point T>
+    T *workspace<T>::reserve(std::size_t size)
+    {
+        NUM_STATS_PHASE(allocation);
+        if (_values.size() < size)
+            _values.resize(size);
+        return _values.data();
+    }
+
+    template<std::floating_point T>
+    std::size_t workspace<T>::capacity() const
+    {
+        return _values.size();
+    }
+}